@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 #include <pthread.h>
 #include <unistd.h>
 
@@ -20,6 +22,9 @@ typedef struct {
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 int *core_load; // Array to track how many processes each core handles
 
+// Command-line runs can print the results as a single key=value line
+bool summary_output = false;
+
 // Function to calculate waiting time for a range of processes
 void *process_chunk(void *arg) {
     ThreadData *data = (ThreadData *)arg;
@@ -41,7 +46,9 @@ void *process_chunk(void *arg) {
         // Simulate actual processing by sleeping briefly
         usleep(1000); // Sleep for 1ms to simulate work
         
-        printf("Core %d processed P%d\n", data->core_id, data->p_name[i]);
+        if (!summary_output) {
+            printf("Core %d processed P%d\n", data->core_id, data->p_name[i]);
+        }
     }
     
     // Update core load stats
@@ -112,7 +119,7 @@ void display_core_utilization(int num_cores, int n) {
 void parallel_fcfs(int p_name[], int burst_time[], int n, int num_cores) {
     // Limit number of cores to use (cannot exceed number of processes)
     if (num_cores > n) {
-        printf("Notice: Number of cores reduced from %d to %d (equal to number of processes)\n", 
+        if (!summary_output) printf("Notice: Number of cores reduced from %d to %d (equal to number of processes)\n", 
                num_cores, n);
         num_cores = n;
     }
@@ -132,7 +139,7 @@ void parallel_fcfs(int p_name[], int burst_time[], int n, int num_cores) {
     int chunk_size = n / num_cores;
     int remainder = n % num_cores;
     
-    printf("\n===== Process Distribution =====\n");
+    if (!summary_output) printf("\n===== Process Distribution =====\n");
     
     // Create and start threads
     for (int i = 0; i < num_cores; i++) {
@@ -148,11 +155,13 @@ void parallel_fcfs(int p_name[], int burst_time[], int n, int num_cores) {
         thread_data[i].start_idx = i * chunk_size + (i < remainder ? i : remainder);
         thread_data[i].end_idx = (i + 1) * chunk_size + (i + 1 < remainder ? i + 1 : remainder);
         
-        printf("Core %d assigned processes: ", i);
-        for (int j = thread_data[i].start_idx; j < thread_data[i].end_idx; j++) {
-            printf("P%d ", p_name[j]);
+        if (!summary_output) {
+            printf("Core %d assigned processes: ", i);
+            for (int j = thread_data[i].start_idx; j < thread_data[i].end_idx; j++) {
+                printf("P%d ", p_name[j]);
+            }
+            printf("\n");
         }
-        printf("\n");
         
         pthread_create(&threads[i], NULL, process_chunk, &thread_data[i]);
     }
@@ -163,8 +172,20 @@ void parallel_fcfs(int p_name[], int burst_time[], int n, int num_cores) {
     }
     
     // Display results
-    display_results(p_name, burst_time, wt, tat, n);
-    display_core_utilization(num_cores, n);
+    if (summary_output) {
+        int total_wt = 0;
+        int total_tat = 0;
+        for (int i = 0; i < n; i++) {
+            total_wt += wt[i];
+            total_tat += tat[i];
+        }
+        printf("policy=fcfs processes=%d cores=%d total_waiting=%d "
+               "avg_waiting=%.2f avg_turnaround=%.2f\n",
+               n, num_cores, total_wt, (float)total_wt / n, (float)total_tat / n);
+    } else {
+        display_results(p_name, burst_time, wt, tat, n);
+        display_core_utilization(num_cores, n);
+    }
     
     // Clean up
     free(wt);
@@ -172,9 +193,99 @@ void parallel_fcfs(int p_name[], int burst_time[], int n, int num_cores) {
     free(core_load);
 }
 
-int main() {
+void print_usage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("Without arguments the burst times are read interactively.\n\n");
+    printf("  --bursts B1,B2,...     burst times of the processes in arrival order\n");
+    printf("                         (default: the durations of the sample DAG)\n");
+    printf("  --cores N              number of cores (default 4)\n");
+    printf("  --format table|summary result tables, or one key=value line (default summary)\n");
+    printf("  --help                 show this message\n");
+    printf("Exit status: 0 after a run, 1 for invalid arguments.\n");
+}
+
+// Run once with the parameters given on the command line
+int run_batch(int argc, char *argv[]) {
+    int sample_bursts[10] = {172, 105, 252, 91, 120, 138, 47, 65, 185, 78};
+    int num_cores = 4;
+    const char *bursts = NULL;
+    
+    summary_output = true;
+    
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 1;
+        }
+        
+        if (strcmp(arg, "--bursts") == 0) {
+            bursts = value;
+        } else if (strcmp(arg, "--cores") == 0) {
+            num_cores = atoi(value);
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "table") == 0) {
+            summary_output = false;
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "summary") == 0) {
+            summary_output = true;
+        } else {
+            fprintf(stderr, "Invalid option: %s %s\n", arg, value);
+            return 1;
+        }
+        i++;
+    }
+    if (num_cores <= 0) {
+        fprintf(stderr, "Number of cores must be positive\n");
+        return 1;
+    }
+    
+    // Count and parse the comma-separated burst times
+    int n = 10;
+    if (bursts) {
+        n = 1;
+        for (const char *p = bursts; *p; p++) {
+            if (*p == ',') n++;
+        }
+    }
+    int *p_name = (int *)malloc(n * sizeof(int));
+    int *burst_time = (int *)malloc(n * sizeof(int));
+    const char *p = bursts;
+    for (int i = 0; i < n; i++) {
+        p_name[i] = i + 1;
+        if (!bursts) {
+            burst_time[i] = sample_bursts[i];
+            continue;
+        }
+        char *end;
+        long value = strtol(p, &end, 10);
+        if (end == p || value < 0 || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Burst times must be comma-separated non-negative integers\n");
+            free(p_name);
+            free(burst_time);
+            return 1;
+        }
+        burst_time[i] = (int)value;
+        p = end + 1;
+    }
+    
+    parallel_fcfs(p_name, burst_time, n, num_cores);
+    
+    free(p_name);
+    free(burst_time);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
     int n, num_cores;
     
+    if (argc > 1) {
+        return run_batch(argc, argv);
+    }
+    
     printf("Enter the number of processes in the ready queue: ");
     scanf("%d", &n);
     
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <unistd.h>
 
 typedef struct {
@@ -24,6 +25,11 @@ typedef struct {
     int total_idle_time;      // Statistics: total time spent idle
 } Core;
 
+// Command-line runs skip the visualization delay and progress bar; with
+// summary output the results are a single key=value line
+bool batch_mode = false;
+bool summary_output = false;
+
 // Function to introduce a short delay for visualization purposes
 void delay_ms(int ms) {
     // Only delay if value is reasonable (avoid very long pauses)
@@ -81,8 +87,9 @@ int find_next_ready_process(Process processes[], int n, int last_idx) {
     return next_idx;
 }
 
-// Multi-core round robin scheduling algorithm
-void multi_core_round_robin(Process processes[], int n, int num_cores, int time_quantum, bool debug_mode) {
+// Multi-core round robin scheduling algorithm. Returns the number of
+// processes that completed before the time limit.
+int multi_core_round_robin(Process processes[], int n, int num_cores, int time_quantum, bool debug_mode) {
     // Initialize cores
     Core* cores = init_cores(num_cores);
     
@@ -199,17 +206,19 @@ void multi_core_round_robin(Process processes[], int n, int num_cores, int time_
             }
         }
         
-        // Show progress periodically
-        if (current_time % 20 == 0) {
-            print_progress_bar(completed_processes, n);
+        if (!batch_mode) {
+            // Show progress periodically
+            if (current_time % 20 == 0) {
+                print_progress_bar(completed_processes, n);
+            }
+            
+            // Small delay for visualization
+            delay_ms(10);
         }
         
-        // Small delay for visualization
-        delay_ms(10);
-        
         // Safety check to prevent infinite loops
         if (current_time > 10000) {
-            printf("\nSimulation exceeded time limit. Exiting.\n");
+            if (!summary_output) printf("\nSimulation exceeded time limit. Exiting.\n");
             break;
         }
     }
@@ -219,6 +228,26 @@ void multi_core_round_robin(Process processes[], int n, int num_cores, int time_
         processes[i].turnaround_time = processes[i].completion_time;  // No arrival offset
     }
     
+    if (summary_output) {
+        int total_waiting = 0;
+        int total_turnaround = 0;
+        int total_idle = 0;
+        for (int i = 0; i < n; i++) {
+            total_waiting += processes[i].waiting_time;
+            total_turnaround += processes[i].turnaround_time;
+        }
+        for (int core_idx = 0; core_idx < num_cores; core_idx++) {
+            total_idle += cores[core_idx].total_idle_time;
+        }
+        printf("policy=rr processes=%d completed=%d cores=%d quantum=%d makespan=%d "
+               "avg_waiting=%.2f avg_turnaround=%.2f avg_utilization=%.2f\n",
+               n, completed_processes, num_cores, time_quantum, current_time,
+               (float)total_waiting / n, (float)total_turnaround / n,
+               100.0 - (float)total_idle / num_cores / current_time * 100.0);
+        free(cores);
+        return completed_processes;
+    }
+    
     // Print results
     printf("\n===== Multi-Core Round Robin Results =====\n");
     printf("Process    | Burst Time | Completion | Waiting | Turnaround\n");
@@ -261,6 +290,7 @@ void multi_core_round_robin(Process processes[], int n, int num_cores, int time_
     
     // Free allocated memory
     free(cores);
+    return completed_processes;
 }
 
 // Create sample processes matching the sample DAG in scheduler.c
@@ -321,12 +351,145 @@ Process* create_custom_processes(int* num_processes) {
     return processes;
 }
 
+// Parse a comma-separated list of non-negative integers. Returns the
+// number of values, or -1 if the list is malformed.
+int parse_int_list(const char* text, int** values) {
+    int count = 1;
+    for (const char* p = text; *p; p++) {
+        if (*p == ',') count++;
+    }
+    *values = (int*)malloc(count * sizeof(int));
+    
+    const char* p = text;
+    for (int i = 0; i < count; i++) {
+        char* end;
+        long value = strtol(p, &end, 10);
+        if (end == p || value < 0 || (*end != ',' && *end != '\0')) {
+            free(*values);
+            *values = NULL;
+            return -1;
+        }
+        (*values)[i] = (int)value;
+        p = end + 1;
+    }
+    return count;
+}
+
+void print_usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("Without arguments the interactive menu is started.\n\n");
+    printf("  --bursts B1,B2,...     burst times of the processes (default: the sample\n");
+    printf("                         processes matching the sample DAG)\n");
+    printf("  --arrivals A1,A2,...   arrival times, one per burst (default 0)\n");
+    printf("  --quantum Q            time quantum (default 50)\n");
+    printf("  --cores N              number of CPU cores, 1-16 (default 4)\n");
+    printf("  --debug                print every start, preemption and completion\n");
+    printf("  --format table|summary result tables, or one key=value line (default summary)\n");
+    printf("  --help                 show this message\n");
+    printf("Exit status: 0 when every process completed, 1 for invalid arguments,\n");
+    printf("2 when the time limit was reached first.\n");
+}
+
+// Run once with the scheduler parameters given on the command line
+int run_batch(int argc, char* argv[]) {
+    int num_processes = 0, time_quantum = 50, num_cores = 4;
+    int* bursts = NULL;
+    int* arrivals = NULL;
+    int num_arrivals = 0;
+    bool debug_mode = false;
+    Process* processes = NULL;
+    
+    batch_mode = true;
+    summary_output = true;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (strcmp(arg, "--debug") == 0) {
+            debug_mode = true;
+            continue;
+        } else if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 1;
+        }
+        
+        if (strcmp(arg, "--bursts") == 0) {
+            free(bursts);
+            num_processes = parse_int_list(value, &bursts);
+        } else if (strcmp(arg, "--arrivals") == 0) {
+            free(arrivals);
+            num_arrivals = parse_int_list(value, &arrivals);
+        } else if (strcmp(arg, "--quantum") == 0) {
+            time_quantum = atoi(value);
+        } else if (strcmp(arg, "--cores") == 0) {
+            num_cores = atoi(value);
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "table") == 0) {
+            summary_output = false;
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "summary") == 0) {
+            summary_output = true;
+        } else {
+            fprintf(stderr, "Invalid option: %s %s\n", arg, value);
+            return 1;
+        }
+        i++;
+    }
+    
+    if (num_processes < 0 || num_arrivals < 0) {
+        fprintf(stderr, "Burst and arrival times must be comma-separated non-negative integers\n");
+        return 1;
+    }
+    if (arrivals && num_arrivals != (bursts ? num_processes : 10)) {
+        fprintf(stderr, "Give one arrival time per process\n");
+        return 1;
+    }
+    if (time_quantum < 1 || num_cores < 1 || num_cores > 16) {
+        fprintf(stderr, "Quantum must be at least 1 and cores between 1 and 16\n");
+        return 1;
+    }
+    
+    if (!bursts) {
+        processes = create_sample_processes(&num_processes);
+    } else {
+        processes = (Process*)malloc(num_processes * sizeof(Process));
+        for (int i = 0; i < num_processes; i++) {
+            processes[i].id = i;
+            sprintf(processes[i].name, "P%d", i + 1);
+            processes[i].burst_time = bursts[i];
+            processes[i].remaining_time = bursts[i];
+            processes[i].waiting_time = 0;
+            processes[i].turnaround_time = 0;
+            processes[i].completion_time = 0;
+            processes[i].arrival_time = 0;
+            processes[i].is_completed = false;
+            processes[i].core_assigned = -1;
+        }
+    }
+    for (int i = 0; arrivals && i < num_processes; i++) {
+        processes[i].arrival_time = arrivals[i];
+    }
+    
+    int completed = multi_core_round_robin(processes, num_processes, num_cores, time_quantum, debug_mode);
+    
+    free(processes);
+    free(bursts);
+    free(arrivals);
+    return (completed == num_processes) ? 0 : 2;
+}
+
 // Main function
-int main() {
+int main(int argc, char* argv[]) {
     int choice, num_processes = 0, time_quantum, num_cores;
     Process* processes = NULL;
     bool debug_mode = false;
     
+    if (argc > 1) {
+        return run_batch(argc, argv);
+    }
+    
     printf("\nMulti-Core Round Robin Scheduler\n");
     printf("===============================\n");
     printf("1. Use Sample Processes (matches sample DAG)\n");
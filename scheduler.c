@@ -4,53 +4,482 @@
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define MAX_TASKS 100
-#define MAX_CORES 16
-#define MIN_QUANTUM 10
-#define DEFAULT_QUANTUM 50
+#define MIN_QUANTUM 10          // in time units
+#define DEFAULT_QUANTUM 50      // in milliseconds
+#define DEFAULT_HORIZON_MS 10000
+#define SPEED_NOMINAL 100       // core speed in percent of one work unit per time unit
+#define MAX_SPEED 1000
+#define MIN_PRIORITY 1          // non-periodic tasks; periodic ranks start above
+#define RQ_MAX_LEVELS 6         // hierarchical bitmap depth, 64^6 dispatch keys
+#define DEFAULT_CP_WEIGHT 50    // percent of critical path in the hybrid policy
+#define DEFAULT_MAX_DEPS 2      // most predecessors per generated task
+#define GENERATOR_WINDOW 16     // generated tasks depend on one of the previous 16
+#define WS_BANDS 16             // priority bands per work-stealing core
+#define WS_INITIAL_CAPACITY 64  // slots in a fresh deque array
+#define EVENT_RING_SIZE 4096    // records per core event ring, power of two
+#define EVENT_LOG_MAGIC "EVLG"
+#define EVENT_LOG_VERSION 1
+#define LOADER_BUFFER_SIZE (1 << 20)  // bytes read at a time from DAG files
+#define DAG_BINARY_MAGIC "DAGB"
+#define DAG_BINARY_VERSION 1
+#define DAG_BINARY_EDGE_COSTS 1u      // header flag: cost sections present
 
+// Simulation clock value, counted in ticks of the configured time unit
+typedef long long SimTime;
+
+typedef enum {
+    TIME_UNIT_MS,
+    TIME_UNIT_US,
+    TIME_UNIT_NS
+} TimeUnit;
+
+// Work run for a task by the threaded execution engine
+typedef void (*TaskPayload)(int task_id, void* arg);
+
+// Cold per-task data: identity, static parameters and results. Only touched
+// while building the DAG and when reporting; dependencies live in the CSR
+// arrays of the DAG.
 typedef struct {
     int id;
     char name[20];
-    int duration; // in milliseconds
-    int period;   // period for RMS (in milliseconds) - added for RMS
-    int priority; // will be calculated based on period (RMS)
-    int dependencies[MAX_TASKS];
-    int dep_count;
-    bool completed;
-    int remaining_time;
-    int core_assigned;
-    int start_time;
-    int finish_time;
+    SimTime duration; // in time units
+    SimTime deadline; // relative deadline, 0 = implicit (the period)
+    SimTime start_time;
+    SimTime finish_time;
+    SimTime total_response;  // summed over completed jobs (periodic mode)
+    SimTime max_response;
+    int finish_core;           // core that completed the (last) job, -1 before
+    int last_core;             // core that preempted the current job, -1 if none
+    SimTime affinity_deadline; // affinity dispatch: wait for last_core until then, -1 if not waiting
+    int migrations;            // resumptions on a core other than last_core
+    long long deadline_jobs;   // completed jobs that had a deadline
+    long long deadline_misses;
+    SimTime max_lateness;      // finish - absolute deadline, LLONG_MIN if none
+    SimTime total_tardiness;   // sum of positive lateness
+    TaskPayload payload;  // NULL runs a busy loop for `duration`
+    void* payload_arg;
 } Task;
 
 typedef struct {
     Task* tasks;
     int num_tasks;
-    int** adjacency_matrix;
+    int task_capacity;   // per-task arrays grow by doubling in add_task()
+    // Hot per-task state, one dense array per field (structure of arrays) so
+    // the scheduling loop only pulls the fields it reads into cache
+    SimTime* remaining_time; // work left, in time units at nominal speed x SPEED_NOMINAL
+    SimTime* period;     // period for RMS (in time units)
+    int* priority;       // rank of the period among all distinct periods (RMS)
+    SimTime* upward_rank; // bottom level: longest path to a sink including own duration
+    int* dispatch_key;   // dense rank under the active policy, 0 = dispatched first
+    SimTime* release_time; // when the current job became ready
+    SimTime* abs_deadline; // release + relative deadline, LLONG_MAX if none (EDF)
+    // Periodic jobs: a task runs its jobs in order, so per-task counters
+    // replace per-job storage. pending_deps counts predecessors that still
+    // owe the job of the current iteration.
+    long long* job_count;  // jobs released before the horizon (1 unless periodic)
+    long long* jobs_done;  // index of the current job
+    SimTime* job_start;    // start of the current job, -1 before it runs
+    int* pending_deps;   // dependencies not yet completed
+    int* core_assigned;
+    bool* completed;
+    // Edges are collected in insertion order, then packed once by build_csr()
+    int num_edges;
+    int edge_capacity;
+    int* edge_from;
+    int* edge_to;
+    SimTime* edge_cost;  // NULL until an edge with a transfer cost is added
+    // Compressed sparse row storage: successors of task i are
+    // succ_targets[succ_offsets[i] .. succ_offsets[i + 1]), predecessors
+    // likewise through pred_offsets/pred_sources
+    int* succ_offsets;
+    int* succ_targets;
+    int* pred_offsets;
+    int* pred_sources;
+    // Data-transfer cost of each edge in both CSR orders, NULL when no edge
+    // has one. pred_edge_index maps a successor entry to its predecessor
+    // entry; edge_finish/edge_core record, per predecessor entry, when and
+    // where the predecessor produced the data for the successor's current job.
+    SimTime* succ_costs;
+    SimTime* pred_costs;
+    int* pred_edge_index;
+    SimTime* edge_finish;
+    int* edge_core;
     bool has_cycles;
+    // Cached by detect_cycles(): a topological order (tasks on a cycle are
+    // left out), sources first in id order, and each task's level, i.e. its
+    // longest distance in edges from a source (-1 on a cycle)
+    int* topo_order;
+    int topo_count;
+    int num_sources;
+    int* level;
+    int num_levels;
+    int num_keys;        // distinct dispatch keys in use
+    int max_priority;    // highest RMS rank, i.e. the shortest period
+    // Binary DAG files are mapped; arrays inside the mapping are not freed
+    void* mapping;
+    size_t mapping_size;
 } DAG;
 
 typedef struct {
     int core_id;
-    Task* current_task;
-    int time_slice_remaining;
+    int current_task;  // task id, -1 when idle
+    SimTime time_slice_remaining;
     bool is_idle;
-    int total_idle_time;
+    SimTime total_idle_time;
+    int speed;         // percent of nominal; retires `speed` work per time unit
+    SimTime work_done; // in nominal time units x SPEED_NOMINAL
+    int tasks_finished;
+    // Scheduling overhead: dead time charged when a task is dispatched
+    int last_task;               // task the core ran last, -1 if none
+    SimTime overhead_remaining;  // dead time left before the task runs
+    SimTime overhead_time;
+    int context_switches;
+    int migrations;          // preempted tasks resumed here from another core
+    int cluster_migrations;  // ... of which came from a core in the same cache cluster
+    int cache_refills;
+    // Data transfers: a task waits for inputs produced on other cores
+    SimTime transfer_remaining;  // wait left before the task runs, after overhead
+    SimTime transfer_time;
+    int remote_inputs;           // costed inputs that came from another core
+    int local_inputs;            // costed inputs produced on this core
+    // Slice being run, for the timeline trace
+    SimTime slice_start;
+    SimTime slice_overhead;
+    SimTime slice_transfer;
+    // Work-stealing statistics (threaded engine only)
+    int tasks_run;
+    int steals;
+    long long failed_steals;
+    long long steal_latency_ns;  // duration of the successful steal attempts, summed
 } Core;
 
+typedef enum {
+    TRACE_COMPLETED,  // the task finished its job
+    TRACE_PREEMPTED,  // the quantum expired
+    TRACE_STOPPED     // the horizon was reached while it ran
+} TraceEnd;
+
+// One run of a task on a core for the timeline trace, in nanoseconds since
+// the start of the run
+typedef struct {
+    long long start_ns;
+    long long end_ns;
+    long long overhead_ns;  // dead time at the start of the slice
+    long long transfer_ns;  // input wait after the overhead
+    int task_id;
+    TraceEnd end;
+} TraceSlice;
+
+// Per-core slice buffer; only the core's own worker appends to it
+typedef struct {
+    TraceSlice* slices;
+    int count;
+    int capacity;
+} TraceBuffer;
+
+// Ready queue in the style of the Linux O(1) scheduler: one FIFO bucket per
+// dispatch key and a hierarchical bitmap of non-empty buckets. bits[0] has
+// one bit per key and every level above has one bit per word of the level
+// below, so finding the most urgent bucket costs one ctz per level. Tasks
+// are linked through per-task next/prev arrays, so no allocation happens
+// while running.
+//
+// Under EDF the bucket order is replaced by a binary min-heap on absolute
+// deadline; a push sequence number keeps equal deadlines FIFO.
+typedef struct {
+    int num_keys;
+    int num_levels;
+    unsigned long long* bits[RQ_MAX_LEVELS];
+    int* head;
+    int* tail;
+    int* next;
+    int* prev;
+    int count;
+    bool by_deadline;
+    int* heap;             // task ids, heap-ordered on (abs_deadline, seq)
+    long long* seq;        // push order per task
+    long long next_seq;
+} ReadyQueue;
+
+// Jobs whose dependencies are met but whose periodic release lies in the
+// future, as a binary min-heap on (release_time, task id)
+typedef struct {
+    int* heap;
+    int count;
+} ReleaseQueue;
+
+typedef enum {
+    POLICY_RMS,            // shortest period first
+    POLICY_CRITICAL_PATH,  // largest upward rank (bottom level) first
+    POLICY_HYBRID,         // weighted blend of both
+    POLICY_EDF             // earliest absolute deadline first (dynamic)
+} SchedPolicy;
+
+typedef enum {
+    ENGINE_TICK,     // step the clock one time unit at a time
+    ENGINE_EVENT,    // jump to the next completion or quantum expiry
+    ENGINE_THREADED  // run task payloads on one POSIX thread per core
+} SimEngine;
+
+// Circular array behind a work-stealing deque; replaced by a larger copy
+// when full. Retired arrays stay alive until the engine shuts down because
+// a thief may still be reading them.
+typedef struct WsArray {
+    long long capacity;  // power of two
+    struct WsArray* retired;
+    atomic_int slots[];
+} WsArray;
+
+// Chase-Lev deque: the owning core pushes and takes at the bottom, other
+// cores steal from the top
+typedef struct {
+    atomic_llong top;
+    atomic_llong bottom;
+    _Atomic(WsArray*) array;
+} WsDeque;
+
+typedef enum {
+    EVENT_STARTED,    // a worker started the task's payload
+    EVENT_COMPLETED,  // ... and finished it
+    EVENT_STOLEN      // the worker stole the task from another core
+} EventType;
+
+// Fixed-size binary trace record of the threaded engine, stored as is in
+// the event log
+typedef struct {
+    uint64_t time_ns;  // since the engine started
+    int32_t task_id;
+    uint16_t core_id;
+    uint8_t type;      // EventType
+    uint8_t reserved;
+} EventRecord;
+
+// Single-producer single-consumer ring: a core's worker publishes records
+// at head and the drainer thread consumes them at tail. The counters sit
+// on separate cache lines; a full ring drops the record instead of
+// blocking the worker.
+typedef struct {
+    atomic_ullong head;  // next slot to write, advanced by the worker
+    char head_pad[64 - sizeof(atomic_ullong)];
+    atomic_ullong tail;  // next slot to read, advanced by the drainer
+    char tail_pad[64 - sizeof(atomic_ullong)];
+    long long dropped;   // worker only; read after the workers are joined
+    EventRecord slots[EVENT_RING_SIZE];
+} EventRing;
+
+// Header of a binary event log, followed by `records` EventRecords in
+// drain order (grouped by core, not globally sorted)
+typedef struct {
+    char magic[4];       // EVENT_LOG_MAGIC
+    uint32_t version;
+    int32_t num_cores;
+    int32_t num_tasks;
+    uint64_t records;
+    uint64_t dropped;
+} EventLogHeader;
+
+// Background thread that empties the event rings into the binary log and,
+// in debug mode, collects them to print as execution trace lines
+typedef struct {
+    EventRing* rings;
+    int num_rings;
+    DAG* dag;
+    FILE* file;          // binary log, NULL when only printing
+    // Debug mode: every record, printed in time order once the workers
+    // stop (the rings are drained core by core, so printing them as they
+    // come would interleave the cores out of time order)
+    EventRecord* debug_records;
+    size_t debug_count;
+    size_t debug_capacity;
+    atomic_bool stop;
+    unsigned long long records;
+    pthread_t thread;
+} EventLogger;
+
+// Shared state of the threaded execution engine. There is no global lock:
+// each core owns one deque per priority band and idle cores steal.
+typedef struct {
+    DAG* dag;
+    int num_cores;
+    WsDeque* deques;        // num_cores * WS_BANDS, indexed core * WS_BANDS + band
+    atomic_int in_flight;   // tasks queued or running; no work left at zero
+    long long epoch_ns;     // engine start on the monotonic clock
+    EventRing* rings;       // per-core event rings, NULL when not logging
+} ThreadedEngine;
+
+typedef struct {
+    ThreadedEngine* engine;
+    int core_id;
+    SimTime busy_time;
+} Worker;
+
+typedef enum {
+    DISPATCH_FIRST_IDLE,  // idle cores in index order take the next ready task
+    DISPATCH_EFT,         // the idle core that finishes the task first
+    DISPATCH_AFFINITY     // the task's previous core or its cache cluster, else EFT
+} DispatchRule;
+
+typedef enum {
+    VERDICT_PASS,          // the test guarantees schedulability
+    VERDICT_FAIL,          // the task set is not schedulable
+    VERDICT_INCONCLUSIVE   // a sufficient test that did not pass
+} Verdict;
+
+// Result of the offline analysis. Per-task worst-case response times are in
+// microseconds, -1 when the bound exceeds the task's deadline (or horizon).
+typedef struct {
+    double utilization;
+    double liu_layland_bound;
+    Verdict liu_layland;       // uniprocessor, RMS
+    double hyperbolic_product;
+    Verdict hyperbolic;        // uniprocessor, RMS
+    Verdict rta;               // exact uniprocessor fixed-priority test
+    double* rta_wcrt_us;
+    SimTime critical_path;     // longest path including durations
+    SimTime volume;            // total work
+    double dag_bound;          // Graham: len + (vol - len) / m
+    Verdict dag;               // against the horizon, on num_cores
+    double* dag_wcrt_us;
+} SchedAnalysis;
+
+// Deadline metrics summed over all tasks, and per RMS priority
+typedef struct {
+    long long deadline_jobs;
+    long long misses;
+    SimTime max_lateness;      // LLONG_MIN when no job had a deadline
+    SimTime total_tardiness;
+    int max_priority;
+    long long* jobs_by_priority;     // indexed by priority, 0..max_priority
+    long long* misses_by_priority;
+} DeadlineTotals;
+
+typedef enum {
+    OUTPUT_TABLE,    // human-readable result tables
+    OUTPUT_SUMMARY,  // a single key=value line per run
+    OUTPUT_CSV,      // per-task results as CSV on stdout
+    OUTPUT_NONE      // results are only kept for the caller
+} OutputFormat;
+
+// Chunked reader for DAG files: lines are returned in place from a large
+// buffer, so loading costs one read() per LOADER_BUFFER_SIZE bytes
+typedef struct {
+    FILE* file;
+    char* buffer;
+    size_t capacity;
+    size_t start;        // unread bytes are buffer[start .. end)
+    size_t end;
+    bool eof;
+    long line;           // number of the last line returned
+} LineReader;
+
+typedef struct {
+    const char* path;
+    DAG* dag;
+    bool* defined;       // per task: declared by the file, not a placeholder
+    int defined_capacity;
+    LineReader reader;
+} DagLoader;
+
+// Sections of a binary DAG file, in file order
+enum {
+    DAG_SEC_DURATION,        // SimTime per task
+    DAG_SEC_PERIOD,          // SimTime per task
+    DAG_SEC_DEADLINE,        // SimTime per task
+    DAG_SEC_PRIORITY,        // int32 per task
+    DAG_SEC_SUCC_OFFSETS,    // int32, num_tasks + 1
+    DAG_SEC_SUCC_TARGETS,    // int32 per edge
+    DAG_SEC_PRED_OFFSETS,    // int32, num_tasks + 1
+    DAG_SEC_PRED_SOURCES,    // int32 per edge
+    DAG_SEC_TOPO_ORDER,      // int32 per task, topo_count used
+    DAG_SEC_LEVEL,           // int32 per task
+    DAG_SEC_SUCC_COSTS,      // SimTime per edge, only with edge costs
+    DAG_SEC_PRED_COSTS,      // SimTime per edge, only with edge costs
+    DAG_SEC_PRED_EDGE_INDEX, // int32 per edge, only with edge costs
+    DAG_SECTIONS
+};
+
+// Header of the binary DAG format. Everything is little-endian and each
+// section starts at an 8-byte aligned byte offset, so the arrays of a
+// mapped file can be used in place. Bump DAG_BINARY_VERSION on any change.
+typedef struct {
+    char magic[4];             // DAG_BINARY_MAGIC
+    uint32_t version;
+    uint32_t time_unit;        // TimeUnit of every time in the file
+    uint32_t flags;
+    int32_t num_tasks;
+    int32_t num_edges;
+    int32_t topo_count;
+    int32_t num_sources;
+    int32_t num_levels;
+    int32_t max_priority;
+    int32_t has_cycles;
+    int32_t reserved;
+    uint64_t section[DAG_SECTIONS];  // byte offsets, 0 if absent
+} DagFileHeader;
+
 // Global variables
 DAG* current_dag = NULL;
 Core* cores = NULL;
-int simulation_time = 0;
+ReadyQueue ready_queue;
+ReleaseQueue release_queue;
+SimTime simulation_time = 0;
 int completed_tasks = 0;
-int quantum = DEFAULT_QUANTUM;
+long long total_jobs = 0;
+long long completed_jobs = 0;
+SimTime quantum = DEFAULT_QUANTUM;
+TimeUnit time_unit = TIME_UNIT_MS;
+SimTime simulation_horizon = DEFAULT_HORIZON_MS;  // runs stop after this time
+bool horizon_is_default = true;  // periodic runs then use the hyperperiod
+SimTime run_horizon = DEFAULT_HORIZON_MS;  // horizon in effect for the current run
+bool periodic_mode = false;  // release a job every period up to the horizon
+double dag_load_ms = 0;  // time the last DAG file took to load
+char job_csv_path[256] = "";  // per-job CSV stream in periodic mode, "-" for stdout
+FILE* job_log = NULL;
+char trace_path[256] = "";    // Chrome Trace JSON timeline, "" for none
+TraceBuffer* trace_buffers = NULL;  // one per core while recording
+char event_log_path[256] = "";  // binary event log of the threaded engine, "" for none
 bool debug_mode = false;
+SimEngine sim_engine = ENGINE_EVENT;
+SchedPolicy sched_policy = POLICY_RMS;
+DispatchRule dispatch_rule = DISPATCH_EFT;
+int* core_speed_config = NULL;  // per-core speed in percent, cores beyond it run at nominal
+int num_core_speeds = 0;
+SimTime context_switch_cost = 0;  // dead time when a core switches to another task
+SimTime migration_cost = 0;       // extra when a preempted task resumes on another core
+SimTime cache_refill_cost = 0;    // extra when it resumes on its core after another task ran there
+bool edge_costs_enabled = false;  // honour dependency transfer costs
+int cluster_size = 1;             // consecutive cores sharing a cache
+SimTime affinity_wait = 0;        // affinity dispatch: longest wait for the previous core
+int* affinity_held = NULL;        // scratch list of tasks held back in one dispatch round
+SimTime hold_recheck = LLONG_MAX;  // earliest instant a task held back this round may be placed
+int cp_weight = DEFAULT_CP_WEIGHT;  // hybrid policy: critical path share in percent
+bool headless_mode = false;  // batch run: no per-event output, progress bar or delays
+OutputFormat output_format = OUTPUT_TABLE;
 
 // Function prototypes
+void* checked_calloc(size_t count, size_t size, const char* what);
+void* checked_realloc(void* ptr, size_t count, size_t size, const char* what);
 DAG* create_sample_dag();
+DAG* create_random_dag(int num_tasks, int max_deps, unsigned int seed);
 DAG* create_custom_dag();
+DAG* load_dag_file(const char* path);
+DAG* map_binary_dag(const char* path);
+bool write_binary_dag(DAG* dag, const char* path);
+int convert_dag_file(const char* in_path, const char* out_path);
+void free_dag_array(DAG* dag, void* array);
+SimTime rescale_time(SimTime value, SimTime from, SimTime to);
+bool add_loaded_edge(DagLoader* loader, long long from, long long to, SimTime cost);
+long long monotonic_ns();
 void display_dag(DAG* dag);
 void run_performance_comparison(int num_cores);
 void export_results_to_csv(DAG* dag, char* scheduler_name, int num_cores);
@@ -59,10 +488,59 @@ void detect_cycles(DAG* dag);
 bool is_task_ready(DAG* dag, int task_id);
 void reset_dag_execution(DAG* dag);
 void simulate_hybrid_scheduler(DAG* dag, int num_cores);
-int find_highest_priority_ready_task(DAG* dag);
-void print_execution_trace(int time, int core_id, Task* task, const char* event);
+void run_tick_engine(DAG* dag, int num_cores);
+void run_event_engine(DAG* dag, int num_cores);
+void run_threaded_engine(DAG* dag, int num_cores);
+void set_task_payload(DAG* dag, int task_id, TaskPayload payload, void* arg);
+void print_work_stealing_stats(int num_cores);
+void rq_init(ReadyQueue* rq, int num_tasks, int num_keys);
+void rq_free(ReadyQueue* rq);
+void rq_push(ReadyQueue* rq, DAG* dag, int task_id);
+int rq_pop(ReadyQueue* rq, DAG* dag);
+int rq_peek(ReadyQueue* rq);
+void rq_push_front(ReadyQueue* rq, DAG* dag, int task_id);
+void heap_sift_up(ReadyQueue* rq, DAG* dag, int task_id);
+SimTime core_free_time(DAG* dag, int core_id);
+SimTime run_time_on_core(DAG* dag, int task_id, int core_id);
+bool parse_core_speeds(const char* list);
+void print_execution_trace(DAG* dag, SimTime time, int core_id, int task_id, const char* event);
+void trace_slice(int core_id, int task_id, long long start_ns, long long end_ns,
+                 long long overhead_ns, long long transfer_ns, TraceEnd end);
+void trace_core_slice(int core_id, TraceEnd end);
+bool write_chrome_trace(DAG* dag, int num_cores, const char* path);
+int decode_event_log(DAG* dag, const char* path);
 void print_progress_bar(int progress, int total);
 void apply_rate_monotonic_scheduling(DAG* dag); // New function for RMS
+void compute_upward_ranks(DAG* dag);
+void compute_dispatch_keys(DAG* dag);
+void compare_policies(DAG* dag, int num_cores);
+bool compare_engines(DAG* dag, int num_cores);
+void release_task(DAG* dag, int task_id, SimTime time);
+void schedule_job(DAG* dag, int task_id);
+void release_due_jobs(DAG* dag);
+SimTime hyperperiod(DAG* dag);
+void print_utilization_bounds(DAG* dag, int num_cores);
+void print_job_statistics(DAG* dag);
+void print_slow_core_tasks(DAG* dag, int num_cores);
+void print_scheduling_overhead(int num_cores);
+void print_migrations(DAG* dag, int num_cores);
+void print_deadline_metrics(DAG* dag);
+SimTime effective_horizon(DAG* dag);
+void analyze_schedulability(DAG* dag, int num_cores, SchedAnalysis* analysis);
+void free_schedulability_analysis(SchedAnalysis* analysis);
+void print_schedulability_analysis(DAG* dag, int num_cores, SchedAnalysis* analysis);
+void print_analysis_summary(SchedAnalysis* analysis);
+int add_task(DAG* dag, SimTime duration, SimTime period);
+void add_dependency(DAG* dag, int task, int depends_on);
+void add_weighted_dependency(DAG* dag, int task, int depends_on, SimTime cost);
+SimTime data_ready_time(DAG* dag, int task_id, int core_id);
+void print_data_transfers(DAG* dag, int num_cores);
+void build_csr(DAG* dag);
+void set_time_unit(TimeUnit unit);
+void print_simulation_results(DAG* dag, int num_cores);
+void print_simulation_summary(DAG* dag, int num_cores);
+void write_task_results_csv(FILE* file, DAG* dag);
+int run_batch(int argc, char* argv[]);
 
 void clear_screen() {
     #ifdef _WIN32
@@ -79,148 +557,430 @@ void delay_ms(int ms) {
     }
 }
 
+SimTime ticks_per_ms(TimeUnit unit) {
+    switch (unit) {
+        case TIME_UNIT_US: return 1000LL;
+        case TIME_UNIT_NS: return 1000000LL;
+        default: return 1LL;
+    }
+}
+
+const char* engine_name(SimEngine engine) {
+    switch (engine) {
+        case ENGINE_TICK: return "tick";
+        case ENGINE_THREADED: return "threaded";
+        default: return "event";
+    }
+}
+
+const char* policy_name(SchedPolicy policy) {
+    switch (policy) {
+        case POLICY_CRITICAL_PATH: return "cp";
+        case POLICY_HYBRID: return "hybrid";
+        case POLICY_EDF: return "edf";
+        default: return "rms";
+    }
+}
+
+const char* dispatch_rule_name(DispatchRule rule) {
+    switch (rule) {
+        case DISPATCH_FIRST_IDLE: return "first-idle";
+        case DISPATCH_AFFINITY: return "affinity";
+        default: return "eft";
+    }
+}
+
+const char* policy_title(SchedPolicy policy) {
+    switch (policy) {
+        case POLICY_CRITICAL_PATH: return "Critical Path Scheduling";
+        case POLICY_HYBRID: return "Hybrid Critical Path/RMS Scheduling";
+        case POLICY_EDF: return "Earliest Deadline First Scheduling";
+        default: return "Rate Monotonic Scheduling";
+    }
+}
+
+const char* time_unit_label(TimeUnit unit) {
+    switch (unit) {
+        case TIME_UNIT_US: return "us";
+        case TIME_UNIT_NS: return "ns";
+        default: return "ms";
+    }
+}
+
+int compare_sim_time(const void* pa, const void* pb) {
+    SimTime a = *(const SimTime*)pa;
+    SimTime b = *(const SimTime*)pb;
+    return (a > b) - (a < b);
+}
+
 // New function to apply Rate Monotonic Scheduling priority assignment
 void apply_rate_monotonic_scheduling(DAG* dag) {
-    // Sort tasks by period (shortest period gets highest priority)
-    // In RMS, priority is inversely proportional to period
-    for (int i = 0; i < dag->num_tasks; i++) {
-        if (dag->tasks[i].period == 0) {
+    // Rank every distinct period: the longest gets MIN_PRIORITY + 1 and
+    // each shorter one the next integer, so priorities order tasks exactly
+    // by period however many periods there are
+    int n = dag->num_tasks;
+    SimTime* periods = (SimTime*)checked_calloc(n, sizeof(SimTime), "RMS priorities");
+    int distinct = 0;
+    for (int i = 0; i < n; i++) {
+        if (dag->period[i] > 0) periods[distinct++] = dag->period[i];
+    }
+    qsort(periods, distinct, sizeof(SimTime), compare_sim_time);
+    int unique = 0;
+    for (int k = 0; k < distinct; k++) {
+        if (unique == 0 || periods[unique - 1] != periods[k]) {
+            periods[unique++] = periods[k];
+        }
+    }
+    dag->max_priority = MIN_PRIORITY + unique;
+    
+    for (int i = 0; i < n; i++) {
+        if (dag->period[i] == 0) {
             // Non-periodic tasks get lowest priority
-            dag->tasks[i].priority = 1;
+            dag->priority[i] = MIN_PRIORITY;
         } else {
-            // Calculate priority: smaller periods get higher priority values
-            // Scale to 1-10 range for compatibility with existing code
-            // Lower period = higher priority number
-            dag->tasks[i].priority = 10 - ((dag->tasks[i].period * 9) / 1000);
-            
-            // Ensure priority is within bounds 1-10
-            if (dag->tasks[i].priority < 1) dag->tasks[i].priority = 1;
-            if (dag->tasks[i].priority > 10) dag->tasks[i].priority = 10;
+            // Position among the sorted periods; lower period = higher priority
+            int lo = 0, hi = unique - 1;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (periods[mid] < dag->period[i]) lo = mid + 1; else hi = mid;
+            }
+            dag->priority[i] = dag->max_priority - lo;
         }
         
         if (debug_mode) {
-            printf("Task %d (%s): Period=%d, Assigned Priority=%d\n", 
+            printf("Task %d (%s): Period=%lld, Assigned Priority=%d\n", 
                   dag->tasks[i].id, dag->tasks[i].name, 
-                  dag->tasks[i].period, dag->tasks[i].priority);
+                  dag->period[i], dag->priority[i]);
         }
     }
+    
+    free(periods);
+}
+
+// Allocate zeroed memory or abort, like the other allocation failures here
+void* checked_calloc(size_t count, size_t size, const char* what) {
+    void* ptr = calloc(count > 0 ? count : 1, size);
+    if (!ptr) {
+        printf("Memory allocation failed for %s\n", what);
+        exit(1);
+    }
+    return ptr;
+}
+
+// Resize an allocation or abort
+void* checked_realloc(void* ptr, size_t count, size_t size, const char* what) {
+    ptr = realloc(ptr, (count > 0 ? count : 1) * size);
+    if (!ptr) {
+        printf("Memory allocation failed for %s\n", what);
+        exit(1);
+    }
+    return ptr;
 }
 
-DAG* create_dag(int num_tasks) {
+// Create an empty DAG; `capacity` is only a hint, tasks are added with add_task()
+DAG* create_dag(int capacity) {
     DAG* dag = (DAG*)malloc(sizeof(DAG));
     if (!dag) {
         printf("Memory allocation failed for DAG\n");
         exit(1);
     }
     
-    dag->num_tasks = num_tasks;
+    if (capacity < 1) capacity = 1;
+    dag->num_tasks = 0;
+    dag->task_capacity = capacity;
     dag->has_cycles = false;
     
-    // Allocate tasks
-    dag->tasks = (Task*)malloc(num_tasks * sizeof(Task));
-    if (!dag->tasks) {
-        printf("Memory allocation failed for tasks\n");
-        free(dag);
-        exit(1);
-    }
+    // Allocate tasks and hot task state
+    dag->tasks = (Task*)checked_calloc(capacity, sizeof(Task), "tasks");
+    dag->remaining_time = (SimTime*)checked_calloc(capacity, sizeof(SimTime), "task state");
+    dag->period = (SimTime*)checked_calloc(capacity, sizeof(SimTime), "task state");
+    dag->priority = (int*)checked_calloc(capacity, sizeof(int), "task state");
+    dag->upward_rank = (SimTime*)checked_calloc(capacity, sizeof(SimTime), "task state");
+    dag->dispatch_key = (int*)checked_calloc(capacity, sizeof(int), "task state");
+    dag->release_time = (SimTime*)checked_calloc(capacity, sizeof(SimTime), "task state");
+    dag->abs_deadline = (SimTime*)checked_calloc(capacity, sizeof(SimTime), "task state");
+    dag->job_count = (long long*)checked_calloc(capacity, sizeof(long long), "task state");
+    dag->jobs_done = (long long*)checked_calloc(capacity, sizeof(long long), "task state");
+    dag->job_start = (SimTime*)checked_calloc(capacity, sizeof(SimTime), "task state");
+    dag->pending_deps = (int*)checked_calloc(capacity, sizeof(int), "task state");
+    dag->core_assigned = (int*)checked_calloc(capacity, sizeof(int), "task state");
+    dag->completed = (bool*)checked_calloc(capacity, sizeof(bool), "task state");
     
-    // Allocate adjacency matrix
-    dag->adjacency_matrix = (int**)malloc(num_tasks * sizeof(int*));
-    if (!dag->adjacency_matrix) {
-        printf("Memory allocation failed for adjacency matrix\n");
-        free(dag->tasks);
-        free(dag);
-        exit(1);
+    // Edge storage grows as dependencies are added
+    dag->num_edges = 0;
+    dag->edge_capacity = 0;
+    dag->edge_from = NULL;
+    dag->edge_to = NULL;
+    dag->edge_cost = NULL;
+    dag->succ_offsets = NULL;
+    dag->succ_targets = NULL;
+    dag->pred_offsets = NULL;
+    dag->pred_sources = NULL;
+    dag->succ_costs = NULL;
+    dag->pred_costs = NULL;
+    dag->pred_edge_index = NULL;
+    dag->edge_finish = NULL;
+    dag->edge_core = NULL;
+    dag->topo_order = NULL;
+    dag->topo_count = 0;
+    dag->num_sources = 0;
+    dag->level = NULL;
+    dag->num_levels = 0;
+    dag->num_keys = 0;
+    dag->max_priority = MIN_PRIORITY;
+    dag->mapping = NULL;
+    dag->mapping_size = 0;
+    dag_load_ms = 0;
+    
+    return dag;
+}
+
+// Append a task and return its id, growing the per-task arrays as needed
+int add_task(DAG* dag, SimTime duration, SimTime period) {
+    if (dag->num_tasks == dag->task_capacity) {
+        int cap = dag->task_capacity * 2;
+        dag->tasks = (Task*)checked_realloc(dag->tasks, cap, sizeof(Task), "tasks");
+        dag->remaining_time = (SimTime*)checked_realloc(dag->remaining_time, cap, sizeof(SimTime), "task state");
+        dag->period = (SimTime*)checked_realloc(dag->period, cap, sizeof(SimTime), "task state");
+        dag->priority = (int*)checked_realloc(dag->priority, cap, sizeof(int), "task state");
+        dag->upward_rank = (SimTime*)checked_realloc(dag->upward_rank, cap, sizeof(SimTime), "task state");
+        dag->dispatch_key = (int*)checked_realloc(dag->dispatch_key, cap, sizeof(int), "task state");
+        dag->release_time = (SimTime*)checked_realloc(dag->release_time, cap, sizeof(SimTime), "task state");
+        dag->abs_deadline = (SimTime*)checked_realloc(dag->abs_deadline, cap, sizeof(SimTime), "task state");
+        dag->job_count = (long long*)checked_realloc(dag->job_count, cap, sizeof(long long), "task state");
+        dag->jobs_done = (long long*)checked_realloc(dag->jobs_done, cap, sizeof(long long), "task state");
+        dag->job_start = (SimTime*)checked_realloc(dag->job_start, cap, sizeof(SimTime), "task state");
+        dag->pending_deps = (int*)checked_realloc(dag->pending_deps, cap, sizeof(int), "task state");
+        dag->core_assigned = (int*)checked_realloc(dag->core_assigned, cap, sizeof(int), "task state");
+        dag->completed = (bool*)checked_realloc(dag->completed, cap, sizeof(bool), "task state");
+        dag->task_capacity = cap;
     }
     
-    for (int i = 0; i < num_tasks; i++) {
-        dag->adjacency_matrix[i] = (int*)calloc(num_tasks, sizeof(int));
-        if (!dag->adjacency_matrix[i]) {
-            printf("Memory allocation failed for adjacency matrix row\n");
-            for (int j = 0; j < i; j++) {
-                free(dag->adjacency_matrix[j]);
-            }
-            free(dag->adjacency_matrix);
-            free(dag->tasks);
-            free(dag);
-            exit(1);
+    int i = dag->num_tasks++;
+    dag->tasks[i].id = i;
+    snprintf(dag->tasks[i].name, sizeof(dag->tasks[i].name), "Task%d", i);
+    dag->tasks[i].duration = duration;
+    dag->tasks[i].deadline = 0;
+    dag->tasks[i].start_time = -1;
+    dag->tasks[i].finish_time = -1;
+    dag->tasks[i].total_response = 0;
+    dag->tasks[i].max_response = 0;
+    dag->tasks[i].finish_core = -1;
+    dag->tasks[i].last_core = -1;
+    dag->tasks[i].affinity_deadline = -1;
+    dag->tasks[i].migrations = 0;
+    dag->tasks[i].deadline_jobs = 0;
+    dag->tasks[i].deadline_misses = 0;
+    dag->tasks[i].max_lateness = LLONG_MIN;
+    dag->tasks[i].total_tardiness = 0;
+    dag->tasks[i].payload = NULL;
+    dag->tasks[i].payload_arg = NULL;
+    dag->remaining_time[i] = duration * SPEED_NOMINAL;
+    dag->period[i] = period;
+    dag->priority[i] = MIN_PRIORITY;
+    dag->upward_rank[i] = duration;
+    dag->dispatch_key[i] = 0;
+    dag->release_time[i] = 0;
+    dag->abs_deadline[i] = LLONG_MAX;
+    dag->job_count[i] = 1;
+    dag->jobs_done[i] = 0;
+    dag->job_start[i] = -1;
+    dag->pending_deps[i] = 0;
+    dag->core_assigned[i] = -1;
+    dag->completed[i] = false;
+    return i;
+}
+
+// Record that `task` depends on `depends_on`
+void add_dependency(DAG* dag, int task, int depends_on) {
+    add_weighted_dependency(dag, task, depends_on, 0);
+}
+
+// Dependency whose output takes `cost` time units to reach another core
+void add_weighted_dependency(DAG* dag, int task, int depends_on, SimTime cost) {
+    if (dag->num_edges == dag->edge_capacity) {
+        dag->edge_capacity = dag->edge_capacity ? dag->edge_capacity * 2 : 16;
+        dag->edge_from = (int*)checked_realloc(dag->edge_from, dag->edge_capacity, sizeof(int), "edge list");
+        dag->edge_to = (int*)checked_realloc(dag->edge_to, dag->edge_capacity, sizeof(int), "edge list");
+        if (dag->edge_cost) {
+            dag->edge_cost = (SimTime*)checked_realloc(dag->edge_cost, dag->edge_capacity, sizeof(SimTime), "edge list");
         }
     }
+    if (cost != 0 && !dag->edge_cost) {
+        dag->edge_cost = (SimTime*)checked_calloc(dag->edge_capacity, sizeof(SimTime), "edge list");
+    }
     
-    // Initialize tasks
-    for (int i = 0; i < num_tasks; i++) {
-        dag->tasks[i].id = i;
-        sprintf(dag->tasks[i].name, "Task%d", i);
-        dag->tasks[i].dep_count = 0;
-        dag->tasks[i].completed = false;
-        dag->tasks[i].core_assigned = -1;
-        dag->tasks[i].start_time = -1;
-        dag->tasks[i].finish_time = -1;
+    // If task depends on depends_on, then there's an edge from depends_on to task
+    dag->edge_from[dag->num_edges] = depends_on;
+    dag->edge_to[dag->num_edges] = task;
+    if (dag->edge_cost) {
+        dag->edge_cost[dag->num_edges] = cost;
     }
+    dag->num_edges++;
+}
+
+// Pack the collected edges into forward and reverse CSR arrays with a
+// counting sort. Rows keep insertion order, so successors are visited in
+// the order their dependencies were declared.
+void build_csr(DAG* dag) {
+    int n = dag->num_tasks;
+    int m = dag->num_edges;
     
-    return dag;
+    dag->succ_offsets = (int*)checked_calloc(n + 1, sizeof(int), "CSR graph");
+    dag->pred_offsets = (int*)checked_calloc(n + 1, sizeof(int), "CSR graph");
+    dag->succ_targets = (int*)checked_calloc(m, sizeof(int), "CSR graph");
+    dag->pred_sources = (int*)checked_calloc(m, sizeof(int), "CSR graph");
+    
+    // Count out/in-degrees, then turn them into row offsets
+    for (int e = 0; e < m; e++) {
+        dag->succ_offsets[dag->edge_from[e] + 1]++;
+        dag->pred_offsets[dag->edge_to[e] + 1]++;
+    }
+    for (int i = 0; i < n; i++) {
+        dag->succ_offsets[i + 1] += dag->succ_offsets[i];
+        dag->pred_offsets[i + 1] += dag->pred_offsets[i];
+    }
+    
+    // Scatter edges into their rows using a per-row cursor
+    int* succ_fill = (int*)checked_calloc(n, sizeof(int), "CSR graph");
+    int* pred_fill = (int*)checked_calloc(n, sizeof(int), "CSR graph");
+    memcpy(succ_fill, dag->succ_offsets, n * sizeof(int));
+    memcpy(pred_fill, dag->pred_offsets, n * sizeof(int));
+    if (dag->edge_cost) {
+        dag->succ_costs = (SimTime*)checked_calloc(m, sizeof(SimTime), "CSR graph");
+        dag->pred_costs = (SimTime*)checked_calloc(m, sizeof(SimTime), "CSR graph");
+        dag->pred_edge_index = (int*)checked_calloc(m, sizeof(int), "CSR graph");
+        dag->edge_finish = (SimTime*)checked_calloc(m, sizeof(SimTime), "CSR graph");
+        dag->edge_core = (int*)checked_calloc(m, sizeof(int), "CSR graph");
+    }
+    for (int e = 0; e < m; e++) {
+        int s = succ_fill[dag->edge_from[e]]++;
+        int p = pred_fill[dag->edge_to[e]]++;
+        dag->succ_targets[s] = dag->edge_to[e];
+        dag->pred_sources[p] = dag->edge_from[e];
+        if (dag->edge_cost) {
+            dag->succ_costs[s] = dag->edge_cost[e];
+            dag->pred_costs[p] = dag->edge_cost[e];
+            dag->pred_edge_index[s] = p;
+            dag->edge_core[p] = -1;
+        }
+    }
+    free(succ_fill);
+    free(pred_fill);
+    
+    // The edge list is no longer needed once the CSR arrays exist
+    free(dag->edge_from);
+    free(dag->edge_to);
+    free(dag->edge_cost);
+    dag->edge_from = NULL;
+    dag->edge_to = NULL;
+    dag->edge_cost = NULL;
+    dag->edge_capacity = 0;
 }
 
 DAG* create_sample_dag() {
     int num_tasks = 10;
     DAG* dag = create_dag(num_tasks);
     
-    // Define task durations and periods (for RMS)
+    // Define task durations and periods in milliseconds (for RMS)
     int durations[10] = {172, 105, 252, 91, 120, 138, 47, 65, 185, 78};
     int periods[10] = {500, 200, 800, 300, 250, 350, 150, 400, 600, 100}; // Added periods for RMS
     
+    SimTime scale = ticks_per_ms(time_unit);
     for (int i = 0; i < num_tasks; i++) {
-        dag->tasks[i].duration = durations[i];
-        dag->tasks[i].remaining_time = durations[i];
-        dag->tasks[i].period = periods[i]; // Set the period
+        add_task(dag, durations[i] * scale, periods[i] * scale);
     }
     
     // Apply RMS to set priorities based on periods
     apply_rate_monotonic_scheduling(dag);
     
-    // Define dependencies (task i depends on task j)
-    int dependencies[][2] = {
-        {1, 0}, // Task 1 depends on Task 0
-        {2, 0}, // Task 2 depends on Task 0
-        {3, 1}, // Task 3 depends on Task 1
-        {4, 1}, // Task 4 depends on Task 1
-        {5, 2}, // Task 5 depends on Task 2
-        {6, 3}, // Task 6 depends on Task 3
-        {6, 4}, // Task 6 also depends on Task 4
-        {7, 5}, // Task 7 depends on Task 5
-        {8, 6}, // Task 8 depends on Task 6
-        {9, 7}, // Task 9 depends on Task 7
-        {9, 8}, // Task 9 also depends on Task 8
+    // Define dependencies (task i depends on task j, transfer cost in ms
+    // when they run on different cores)
+    int dependencies[][3] = {
+        {1, 0, 20}, // Task 1 depends on Task 0
+        {2, 0, 35}, // Task 2 depends on Task 0
+        {3, 1, 15}, // Task 3 depends on Task 1
+        {4, 1, 25}, // Task 4 depends on Task 1
+        {5, 2, 30}, // Task 5 depends on Task 2
+        {6, 3, 10}, // Task 6 depends on Task 3
+        {6, 4, 10}, // Task 6 also depends on Task 4
+        {7, 5, 20}, // Task 7 depends on Task 5
+        {8, 6, 40}, // Task 8 depends on Task 6
+        {9, 7, 15}, // Task 9 depends on Task 7
+        {9, 8, 25}, // Task 9 also depends on Task 8
     };
     
     int num_deps = sizeof(dependencies) / sizeof(dependencies[0]);
     
     // Fill adjacency matrix and dependency lists
     for (int i = 0; i < num_deps; i++) {
-        int task = dependencies[i][0];
-        int depends_on = dependencies[i][1];
-        
-        // FIXED: Proper representation in adjacency matrix
-        // If task depends on depends_on, then there's an edge from depends_on to task
-        dag->adjacency_matrix[depends_on][task] = 1; // Edge from depends_on to task
-        
-        // Add to dependency list
-        dag->tasks[task].dependencies[dag->tasks[task].dep_count++] = depends_on;
+        add_weighted_dependency(dag, dependencies[i][0], dependencies[i][1], dependencies[i][2] * scale);
     }
+    build_csr(dag);
     
     // Check for cycles
     detect_cycles(dag);
     
-    printf("Sample DAG created with %d tasks using Rate Monotonic Scheduling\n", num_tasks);
+    if (!headless_mode) {
+        printf("Sample DAG created with %d tasks using Rate Monotonic Scheduling\n", num_tasks);
+    }
+    return dag;
+}
+
+// Random DAG with the sample DAG's shape of parameters: periods drawn from
+// the sample's periods, durations of 20-300 ms but never above the period
+// (like the sample, no task has C > T) and transfer costs of 10-40 ms. Task i depends on 1..max_deps distinct tasks among the
+// GENERATOR_WINDOW before it, so the graph is acyclic and layered. The
+// same seed always gives the same DAG.
+DAG* create_random_dag(int num_tasks, int max_deps, unsigned int seed) {
+    static const int periods[] = {100, 150, 200, 250, 300, 350, 400, 500, 600, 800};
+    int num_periods = sizeof(periods) / sizeof(periods[0]);
+    DAG* dag = create_dag(num_tasks);
+    SimTime scale = ticks_per_ms(time_unit);
+    srand(seed);
+    
+    for (int i = 0; i < num_tasks; i++) {
+        int period = periods[rand() % num_periods];
+        int longest = period < 300 ? period : 300;
+        add_task(dag, (20 + rand() % (longest - 19)) * scale, period * scale);
+    }
+    apply_rate_monotonic_scheduling(dag);
+    
+    int chosen[GENERATOR_WINDOW];
+    for (int i = 1; i < num_tasks; i++) {
+        int first = i > GENERATOR_WINDOW ? i - GENERATOR_WINDOW : 0;
+        int deps = 1 + rand() % max_deps;
+        if (deps > i - first) deps = i - first;
+        for (int d = 0; d < deps; d++) {
+            int pred;
+            bool duplicate;
+            do {
+                pred = first + rand() % (i - first);
+                duplicate = false;
+                for (int k = 0; k < d; k++) {
+                    if (chosen[k] == pred) duplicate = true;
+                }
+            } while (duplicate);
+            chosen[d] = pred;
+            add_weighted_dependency(dag, i, pred, (10 + rand() % 31) * scale);
+        }
+    }
+    build_csr(dag);
+    detect_cycles(dag);
+    
+    if (!headless_mode) {
+        printf("Random DAG created with %d tasks (seed %u)\n", num_tasks, seed);
+    }
     return dag;
 }
 
 DAG* create_custom_dag() {
     int num_tasks;
-    printf("Enter number of tasks (1-%d): ", MAX_TASKS);
+    const char* unit = time_unit_label(time_unit);
+    printf("Enter number of tasks (at least 1): ");
     scanf("%d", &num_tasks);
     
-    if (num_tasks < 1 || num_tasks > MAX_TASKS) {
+    if (num_tasks < 1) {
         printf("Invalid number of tasks. Using 5 tasks.\n");
         num_tasks = 5;
     }
@@ -228,18 +988,26 @@ DAG* create_custom_dag() {
     DAG* dag = create_dag(num_tasks);
     
     for (int i = 0; i < num_tasks; i++) {
+        SimTime duration, period;
         printf("\nTask %d:\n", i);
         
-        printf("Enter execution time (ms): ");
-        scanf("%d", &dag->tasks[i].duration);
-        dag->tasks[i].remaining_time = dag->tasks[i].duration;
+        printf("Enter execution time (%s): ", unit);
+        scanf("%lld", &duration);
         
-        printf("Enter period (ms, lower period = higher priority, 0 for non-periodic): ");
-        scanf("%d", &dag->tasks[i].period);
+        printf("Enter period (%s, lower period = higher priority, 0 for non-periodic): ", unit);
+        scanf("%lld", &period);
         
-        if (dag->tasks[i].period < 0) {  // Changed from < 1 to < 0
-            printf("Invalid period. Using default (500 ms).\n");
-            dag->tasks[i].period = 500;
+        if (period < 0) {  // Changed from < 1 to < 0
+            period = 500 * ticks_per_ms(time_unit);
+            printf("Invalid period. Using default (%lld %s).\n", period, unit);
+        }
+        
+        int id = add_task(dag, duration, period);
+        
+        printf("Enter relative deadline (%s, 0 = period): ", unit);
+        scanf("%lld", &dag->tasks[id].deadline);
+        if (dag->tasks[id].deadline < 0) {
+            dag->tasks[id].deadline = 0;
         }
     }
     
@@ -275,23 +1043,25 @@ DAG* create_custom_dag() {
         
         // Check if dependency already exists
         bool exists = false;
-        for (int i = 0; i < dag->tasks[task].dep_count; i++) {
-            if (dag->tasks[task].dependencies[i] == depends_on) {
+        for (int e = 0; e < dag->num_edges; e++) {
+            if (dag->edge_to[e] == task && dag->edge_from[e] == depends_on) {
                 exists = true;
                 break;
             }
         }
         
         if (!exists) {
-            // FIXED: Proper representation in adjacency matrix
-            // If task depends on depends_on, then there's an edge from depends_on to task
-            dag->adjacency_matrix[depends_on][task] = 1;
-            dag->tasks[task].dependencies[dag->tasks[task].dep_count++] = depends_on;
+            SimTime cost;
+            printf("Transfer cost when they run on different cores (%s, 0 for none): ", unit);
+            scanf("%lld", &cost);
+            if (cost < 0) cost = 0;
+            add_weighted_dependency(dag, task, depends_on, cost);
             printf("Added: Task %d depends on Task %d\n", task, depends_on);
         } else {
             printf("Dependency already exists\n");
         }
     }
+    build_csr(dag);
     
     // Check for cycles
     detect_cycles(dag);
@@ -299,310 +1069,3108 @@ DAG* create_custom_dag() {
     return dag;
 }
 
-void dfs_cycle_detection(DAG* dag, int node, bool* visited, bool* rec_stack, bool* has_cycle) {
-    if (*has_cycle) return; // Already found a cycle
-    
-    visited[node] = true;
-    rec_stack[node] = true;
-    
-    for (int i = 0; i < dag->num_tasks; i++) {
-        // If there's an edge from node to i
-        if (dag->adjacency_matrix[node][i]) {
-            if (!visited[i]) {
-                dfs_cycle_detection(dag, i, visited, rec_stack, has_cycle);
-                if (*has_cycle) return;
-            } else if (rec_stack[i]) {
-                *has_cycle = true;
-                return;
-            }
+// Next line of the file without its line break, NUL-terminated in place;
+// NULL at end of file. Lines longer than the buffer grow it.
+char* read_line(LineReader* reader) {
+    while (true) {
+        char* start = reader->buffer + reader->start;
+        char* newline = memchr(start, '\n', reader->end - reader->start);
+        if (newline) {
+            *newline = '\0';
+            if (newline > start && newline[-1] == '\r') newline[-1] = '\0';
+            reader->start = newline - reader->buffer + 1;
+            reader->line++;
+            return start;
         }
+        if (reader->eof) {
+            if (reader->start == reader->end) return NULL;
+            reader->buffer[reader->end] = '\0';
+            reader->start = reader->end;
+            reader->line++;
+            return start;
+        }
+        
+        // Keep the partial line and refill behind it
+        memmove(reader->buffer, start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+        if (reader->end == reader->capacity) {
+            reader->capacity *= 2;
+            reader->buffer = (char*)checked_realloc(reader->buffer, reader->capacity + 1, 1, "file buffer");
+        }
+        size_t got = fread(reader->buffer + reader->end, 1, reader->capacity - reader->end, reader->file);
+        if (got == 0) reader->eof = true;
+        reader->end += got;
     }
-    
-    rec_stack[node] = false;
 }
 
-void detect_cycles(DAG* dag) {
-    bool *visited = (bool*)calloc(dag->num_tasks, sizeof(bool));
-    bool *rec_stack = (bool*)calloc(dag->num_tasks, sizeof(bool));
-    bool has_cycle = false;
-    
-    for (int i = 0; i < dag->num_tasks; i++) {
-        if (!visited[i]) {
-            dfs_cycle_detection(dag, i, visited, rec_stack, &has_cycle);
-        }
-    }
-    
-    dag->has_cycles = has_cycle;
-    
-    free(visited);
-    free(rec_stack);
-    
-    if (has_cycle) {
-        printf("WARNING: Cycles detected in the DAG! This may cause scheduler issues.\n");
+// Parse a non-negative integer, skipping leading blanks and an opening quote
+bool parse_count(char** cursor, long long* value) {
+    char* c = *cursor;
+    while (*c == ' ' || *c == '\t' || *c == '"') c++;
+    if (*c < '0' || *c > '9') return false;
+    long long v = 0;
+    while (*c >= '0' && *c <= '9') {
+        if (v > (LLONG_MAX - (*c - '0')) / 10) return false;
+        v = v * 10 + (*c++ - '0');
     }
+    if (*c == '"') c++;
+    *cursor = c;
+    *value = v;
+    return true;
 }
 
-void display_dag(DAG* dag) {
-    if (!dag) {
-        printf("No DAG available. Please create one first.\n");
-        return;
+// Define task `id` of a DAG being loaded. Tasks may come in any order;
+// missing lower ids are added as placeholders that must be defined later.
+bool define_task(DagLoader* loader, long long id, SimTime duration, SimTime period, SimTime deadline) {
+    DAG* dag = loader->dag;
+    if (id > INT_MAX - 1) {
+        printf("%s:%ld: task id %lld is too large\n", loader->path, loader->reader.line, id);
+        return false;
     }
-    
-    printf("\n===== DAG Information =====\n");
-    printf("Number of tasks: %d\n", dag->num_tasks);
-    printf("Has cycles: %s\n", dag->has_cycles ? "Yes (WARNING)" : "No");
-    
-    printf("\nTask Details (using Rate Monotonic Scheduling):\n");
-    printf("ID | Name       | Duration | Period  | Priority | Dependencies\n");
-    printf("----------------------------------------------------------\n");
-    
-    for (int i = 0; i < dag->num_tasks; i++) {
-        printf("%-2d | %-10s | %-8d | %-7d | %-8d | ", 
-               dag->tasks[i].id, 
-               dag->tasks[i].name, 
-               dag->tasks[i].duration, 
-               dag->tasks[i].period,
-               dag->tasks[i].priority);
-        
-        if (dag->tasks[i].dep_count == 0) {
-            printf("None");
-        } else {
-            for (int j = 0; j < dag->tasks[i].dep_count; j++) {
-                printf("%d ", dag->tasks[i].dependencies[j]);
-            }
+    while (dag->num_tasks <= id) {
+        if (dag->num_tasks == loader->defined_capacity) {
+            loader->defined_capacity = loader->defined_capacity ? loader->defined_capacity * 2 : 1024;
+            loader->defined = (bool*)checked_realloc(loader->defined, loader->defined_capacity, sizeof(bool), "task list");
         }
-        printf("\n");
+        loader->defined[add_task(dag, 0, 0)] = false;
+    }
+    if (loader->defined[id]) {
+        printf("%s:%ld: task %lld is defined twice\n", loader->path, loader->reader.line, id);
+        return false;
     }
+    loader->defined[id] = true;
+    dag->tasks[id].duration = duration;
+    dag->tasks[id].deadline = deadline;
+    dag->remaining_time[id] = duration * SPEED_NOMINAL;
+    dag->period[id] = period;
+    return true;
+}
+
+// Plain-text format, one record per line:
+//   task <id> <duration> <period> [<deadline>]
+//   edge <from> <to> [<cost>]     (<to> depends on <from>)
+// Blank lines and lines starting with # are ignored.
+bool parse_text_line(DagLoader* loader, char* line) {
+    char* c = line;
+    while (*c == ' ' || *c == '\t') c++;
+    if (*c == '\0' || *c == '#') return true;
     
-    // FIXED: Updated explanation of adjacency matrix
-    printf("\nAdjacency Matrix (1 means row points to column, i.e., column depends on row):\n");
-    printf("   ");
-    for (int i = 0; i < dag->num_tasks; i++) {
-        printf("%2d ", i);
+    long long v[4] = {0, 0, 0, 0};
+    int count = 0;
+    // The keyword must be followed by a blank, so "tasks" or "taskX" is
+    // not read as a task record
+    bool is_task = strncmp(c, "task", 4) == 0;
+    if ((!is_task && strncmp(c, "edge", 4) != 0) || (c[4] != ' ' && c[4] != '\t' && c[4] != '\0')) {
+        printf("%s:%ld: expected 'task' or 'edge'\n", loader->path, loader->reader.line);
+        return false;
+    }
+    c += 4;
+    while (count < 4 && parse_count(&c, &v[count])) count++;
+    while (*c == ' ' || *c == '\t') c++;
+    if (count < (is_task ? 3 : 2) || (*c != '\0' && *c != '#')) {
+        printf("%s:%ld: expected %s\n", loader->path, loader->reader.line,
+               is_task ? "task <id> <duration> <period> [<deadline>]" : "edge <from> <to> [<cost>]");
+        return false;
     }
-    printf("\n");
     
-    for (int i = 0; i < dag->num_tasks; i++) {
-        printf("%2d ", i);
-        for (int j = 0; j < dag->num_tasks; j++) {
-            printf("%2d ", dag->adjacency_matrix[i][j]);
-        }
-        printf("\n");
+    if (is_task) {
+        return define_task(loader, v[0], v[1], v[2], v[3]);
     }
+    return add_loaded_edge(loader, v[0], v[1], v[2]);
 }
 
-bool is_task_ready(DAG* dag, int task_id) {
-    if (dag->tasks[task_id].completed) {
+bool add_loaded_edge(DagLoader* loader, long long from, long long to, SimTime cost) {
+    if (from > INT_MAX - 1 || to > INT_MAX - 1) {
+        printf("%s:%ld: task id is too large\n", loader->path, loader->reader.line);
         return false;
     }
+    if (from == to) {
+        printf("%s:%ld: task %lld cannot depend on itself\n", loader->path, loader->reader.line, to);
+        return false;
+    }
+    add_weighted_dependency(loader->dag, (int)to, (int)from, cost);
+    return true;
+}
+
+// Graphviz DOT subset: one statement per line or separated by ';', with
+// numeric node ids, e.g.
+//   digraph G {
+//     0 [duration=172, period=500];
+//     0 -> 1 -> 3 [cost=20];
+//   }
+// Node attributes are duration, period and deadline; edge attribute cost.
+// Other attributes and graph/node/edge default statements are ignored.
+bool parse_dot_statement(DagLoader* loader, char* stmt) {
+    char* c = stmt;
+    while (*c == ' ' || *c == '\t') c++;
+    if (*c == '\0' || *c == '}' || *c == '#' || strncmp(c, "//", 2) == 0) return true;
+    if (strncmp(c, "digraph", 7) == 0 || strncmp(c, "strict", 6) == 0 ||
+        strncmp(c, "graph", 5) == 0 || strncmp(c, "node", 4) == 0 || strncmp(c, "edge", 4) == 0) {
+        return true;
+    }
     
-    // Check if all dependencies are completed
-    for (int i = 0; i < dag->tasks[task_id].dep_count; i++) {
-        int dep_id = dag->tasks[task_id].dependencies[i];
-        if (!dag->tasks[dep_id].completed) {
+    // Node chain: id (-> id)*
+    long long ids[2];
+    long long first;
+    if (!parse_count(&c, &first)) {
+        printf("%s:%ld: expected a numeric node id\n", loader->path, loader->reader.line);
+        return false;
+    }
+    int chain_start = loader->dag->num_edges;
+    ids[0] = first;
+    bool is_edge = false;
+    while (true) {
+        while (*c == ' ' || *c == '\t') c++;
+        if (c[0] != '-' || c[1] != '>') break;
+        c += 2;
+        if (!parse_count(&c, &ids[1])) {
+            printf("%s:%ld: expected a numeric node id after ->\n", loader->path, loader->reader.line);
             return false;
         }
+        if (!add_loaded_edge(loader, ids[0], ids[1], 0)) return false;
+        ids[0] = ids[1];
+        is_edge = true;
     }
     
-    return true;
+    // Attributes: [key=value, ...]
+    SimTime duration = -1, period = 0, deadline = 0, cost = 0;
+    if (*c == '[') {
+        c++;
+        while (true) {
+            while (*c == ' ' || *c == '\t' || *c == ',') c++;
+            if (*c == ']' || *c == '\0') break;
+            char* key = c;
+            while (*c && *c != '=' && *c != ']' && *c != ',' && *c != ' ') c++;
+            size_t key_length = c - key;
+            while (*c == ' ') c++;
+            if (*c != '=') continue;
+            c++;
+            while (*c == ' ') c++;
+            long long value;
+            char* value_start = c;
+            bool numeric = parse_count(&c, &value);
+            if (!numeric) {
+                // Skip a non-numeric value, quoted or not
+                c = value_start;
+                if (*c == '"') {
+                    c = strchr(c + 1, '"');
+                    c = c ? c + 1 : value_start + strlen(value_start);
+                } else {
+                    while (*c && *c != ',' && *c != ']' && *c != ' ') c++;
+                }
+            }
+            bool known = true;
+            if (key_length == 8 && strncmp(key, "duration", 8) == 0) duration = value;
+            else if (key_length == 6 && strncmp(key, "period", 6) == 0) period = value;
+            else if (key_length == 8 && strncmp(key, "deadline", 8) == 0) deadline = value;
+            else if (key_length == 4 && strncmp(key, "cost", 4) == 0) cost = value;
+            else known = false;
+            if (known && !numeric) {
+                printf("%s:%ld: %.*s must be a non-negative integer\n", loader->path, loader->reader.line,
+                       (int)key_length, key);
+                return false;
+            }
+        }
+    }
+    
+    if (is_edge) {
+        if (cost > 0) {
+            DAG* dag = loader->dag;
+            if (!dag->edge_cost) {
+                dag->edge_cost = (SimTime*)checked_calloc(dag->edge_capacity, sizeof(SimTime), "edge list");
+            }
+            for (int e = chain_start; e < dag->num_edges; e++) {
+                dag->edge_cost[e] = cost;
+            }
+        }
+        return true;
+    }
+    if (duration < 0) {
+        printf("%s:%ld: node %lld needs a duration\n", loader->path, loader->reader.line, first);
+        return false;
+    }
+    return define_task(loader, first, duration, period, deadline);
 }
 
-int find_highest_priority_ready_task(DAG* dag) {
-    int highest_priority = -1;
-    int selected_task = -1;
+// Load a DAG from a task/edge list or a Graphviz DOT file (detected by a
+// leading "digraph"), or map a binary DAG file (detected by its magic); text
+// formats then build the CSR graph, check for cycles and assign
+// RMS priorities. Times are in the current time unit. Returns NULL and
+// reports the offending line when the file is invalid.
+DAG* load_dag_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("Cannot open DAG file %s\n", path);
+        return NULL;
+    }
+    char magic[4];
+    if (fread(magic, 1, 4, file) == 4 && memcmp(magic, DAG_BINARY_MAGIC, 4) == 0) {
+        fclose(file);
+        return map_binary_dag(path);
+    }
+    rewind(file);
+    long long started = monotonic_ns();
     
-    for (int i = 0; i < dag->num_tasks; i++) {
-        if (is_task_ready(dag, i) && dag->tasks[i].core_assigned == -1) {
-            // RMS: Higher priority value means higher priority
-            if (selected_task == -1 || dag->tasks[i].priority > highest_priority) {
-                highest_priority = dag->tasks[i].priority;
-                selected_task = i;
-            }
-            // If priorities are equal, choose the task with shorter period
-            else if (dag->tasks[i].priority == highest_priority &&
-                     dag->tasks[i].period < dag->tasks[selected_task].period) {
-                selected_task = i;
+    DagLoader loader;
+    loader.path = path;
+    loader.dag = create_dag(1024);
+    loader.defined = NULL;
+    loader.defined_capacity = 0;
+    loader.reader.file = file;
+    loader.reader.capacity = LOADER_BUFFER_SIZE;
+    loader.reader.buffer = (char*)checked_calloc(LOADER_BUFFER_SIZE + 1, 1, "file buffer");
+    loader.reader.start = 0;
+    loader.reader.end = 0;
+    loader.reader.eof = false;
+    loader.reader.line = 0;
+    
+    bool ok = true;
+    bool is_dot = false;
+    bool first_line = true;
+    char* line;
+    while (ok && (line = read_line(&loader.reader)) != NULL) {
+        if (first_line) {
+            char* c = line;
+            while (*c == ' ' || *c == '\t') c++;
+            if (*c == '\0' || *c == '#') continue;
+            is_dot = strncmp(c, "digraph", 7) == 0 || strncmp(c, "strict", 6) == 0;
+            first_line = false;
+        }
+        if (!is_dot) {
+            ok = parse_text_line(&loader, line);
+            continue;
+        }
+        
+        // Braces and ';' separate statements
+        char* stmt = line;
+        while (ok && stmt) {
+            char* end = strpbrk(stmt, ";{}");
+            if (end) {
+                bool open = (*end == '{');
+                *end = '\0';
+                ok = open || parse_dot_statement(&loader, stmt);
+                stmt = end + 1;
+            } else {
+                ok = parse_dot_statement(&loader, stmt);
+                stmt = NULL;
             }
         }
     }
+    fclose(file);
+    free(loader.reader.buffer);
+    
+    DAG* dag = loader.dag;
+    for (int i = 0; ok && i < dag->num_tasks; i++) {
+        if (!loader.defined[i]) {
+            printf("%s: task %d is referenced but never defined\n", path, i);
+            ok = false;
+        }
+    }
+    for (int e = 0; ok && e < dag->num_edges; e++) {
+        int bad = dag->edge_from[e] >= dag->num_tasks ? dag->edge_from[e] :
+                  dag->edge_to[e] >= dag->num_tasks ? dag->edge_to[e] : -1;
+        if (bad != -1) {
+            printf("%s: edge %d -> %d refers to undefined task %d\n", path, dag->edge_from[e], dag->edge_to[e], bad);
+            ok = false;
+        }
+    }
+    if (ok && dag->num_tasks == 0) {
+        printf("%s: no tasks defined\n", path);
+        ok = false;
+    }
+    free(loader.defined);
+    if (!ok) {
+        free_dag(dag);
+        return NULL;
+    }
+    
+    build_csr(dag);
+    detect_cycles(dag);
+    apply_rate_monotonic_scheduling(dag);
+    dag_load_ms = (monotonic_ns() - started) / 1e6;
     
-    return selected_task;
+    if (!headless_mode) {
+        printf("Loaded %d tasks and %d edges from %s in %.1f ms%s\n", dag->num_tasks, dag->num_edges,
+               path, dag_load_ms, dag->has_cycles ? " (WARNING: the graph has cycles)" : "");
+    }
+    return dag;
 }
 
-void reset_dag_execution(DAG* dag) {
-    for (int i = 0; i < dag->num_tasks; i++) {
-        dag->tasks[i].completed = false;
-        dag->tasks[i].remaining_time = dag->tasks[i].duration;
-        dag->tasks[i].core_assigned = -1;
-        dag->tasks[i].start_time = -1;
-        dag->tasks[i].finish_time = -1;
-    }
+bool host_is_little_endian() {
+    uint16_t probe = 1;
+    return *(uint8_t*)&probe == 1;
 }
 
-void print_execution_trace(int time, int core_id, Task* task, const char* event) {
-    if (debug_mode) {
-        printf("Time %d: Core %d - %s %s (Period: %d, Priority: %d, %d ms remaining)\n", 
-               time, core_id, event, task->name, 
-               task->period, task->priority, task->remaining_time);
+// Element size and count of each section of a binary DAG file
+void dag_section_shape(int section, int num_tasks, int num_edges, size_t* size, size_t* count) {
+    switch (section) {
+        case DAG_SEC_DURATION:
+        case DAG_SEC_PERIOD:
+        case DAG_SEC_DEADLINE:
+            *size = sizeof(SimTime); *count = num_tasks; break;
+        case DAG_SEC_PRIORITY:
+        case DAG_SEC_TOPO_ORDER:
+        case DAG_SEC_LEVEL:
+            *size = sizeof(int32_t); *count = num_tasks; break;
+        case DAG_SEC_SUCC_OFFSETS:
+        case DAG_SEC_PRED_OFFSETS:
+            *size = sizeof(int32_t); *count = (size_t)num_tasks + 1; break;
+        case DAG_SEC_SUCC_COSTS:
+        case DAG_SEC_PRED_COSTS:
+            *size = sizeof(SimTime); *count = num_edges; break;
+        default:
+            *size = sizeof(int32_t); *count = num_edges; break;
     }
 }
 
-void print_progress_bar(int progress, int total) {
-    const int bar_width = 50;
-    float percentage = (float)progress / total;
-    int pos = bar_width * percentage;
+// Write a built DAG (CSR graph, cycle check and RMS priorities done) in the
+// binary format. Cost sections are only present when edges have costs.
+bool write_binary_dag(DAG* dag, const char* path) {
+    if (!host_is_little_endian()) {
+        printf("The binary DAG format is little-endian; this host is not\n");
+        return false;
+    }
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("Cannot create binary DAG file %s\n", path);
+        return false;
+    }
     
-    printf("[");
-    for (int i = 0; i < bar_width; i++) {
-        if (i < pos) printf("=");
-        else if (i == pos) printf(">");
-        else printf(" ");
+    int n = dag->num_tasks;
+    int m = dag->num_edges;
+    SimTime* durations = (SimTime*)checked_calloc(n, sizeof(SimTime), "binary DAG");
+    SimTime* deadlines = (SimTime*)checked_calloc(n, sizeof(SimTime), "binary DAG");
+    for (int i = 0; i < n; i++) {
+        durations[i] = dag->tasks[i].duration;
+        deadlines[i] = dag->tasks[i].deadline;
+    }
+    const void* data[DAG_SECTIONS] = {
+        durations, dag->period, deadlines, dag->priority,
+        dag->succ_offsets, dag->succ_targets, dag->pred_offsets, dag->pred_sources,
+        dag->topo_order, dag->level, dag->succ_costs, dag->pred_costs, dag->pred_edge_index
+    };
+    
+    DagFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DAG_BINARY_MAGIC, 4);
+    header.version = DAG_BINARY_VERSION;
+    header.time_unit = time_unit;
+    header.flags = dag->succ_costs ? DAG_BINARY_EDGE_COSTS : 0;
+    header.num_tasks = n;
+    header.num_edges = m;
+    header.topo_count = dag->topo_count;
+    header.num_sources = dag->num_sources;
+    header.num_levels = dag->num_levels;
+    header.max_priority = dag->max_priority;
+    header.has_cycles = dag->has_cycles;
+    
+    // Lay the sections out back to back, each 8-byte aligned
+    uint64_t offset = sizeof(DagFileHeader);
+    for (int s = 0; s < DAG_SECTIONS; s++) {
+        if (!data[s]) continue;
+        size_t size, count;
+        dag_section_shape(s, n, m, &size, &count);
+        header.section[s] = offset;
+        offset = (offset + size * count + 7) & ~(uint64_t)7;
+    }
+    
+    static const char padding[8] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int s = 0; ok && s < DAG_SECTIONS; s++) {
+        if (!data[s]) continue;
+        size_t size, count;
+        dag_section_shape(s, n, m, &size, &count);
+        ok = fwrite(data[s], size, count, file) == count;
+        size_t pad = (8 - (size * count) % 8) % 8;
+        if (ok && pad > 0) ok = fwrite(padding, 1, pad, file) == pad;
+    }
+    ok = (fclose(file) == 0) && ok;
+    free(durations);
+    free(deadlines);
+    if (!ok) {
+        printf("Failed to write binary DAG file %s\n", path);
+    }
+    return ok;
+}
+
+// Check that a mapped file's CSR rows are well formed and every id is in
+// range, so a damaged file cannot send the scheduler out of bounds
+bool valid_csr(const int32_t* offsets, const int32_t* ids, int n, int m) {
+    if (offsets[0] != 0 || offsets[n] != m) return false;
+    for (int i = 0; i < n; i++) {
+        if (offsets[i + 1] < offsets[i]) return false;
+    }
+    for (int e = 0; e < m; e++) {
+        if (ids[e] < 0 || ids[e] >= n) return false;
+    }
+    return true;
+}
+
+// Open a binary DAG file with mmap. The CSR arrays, edge costs,
+// topological order and levels point straight into the private mapping
+// (copy-on-write, so rescaling costs never touches the file); only the
+// mutable per-task records are filled, in one O(V) pass. Returns NULL if
+// the file is not a valid binary DAG.
+DAG* map_binary_dag(const char* path) {
+    long long started = monotonic_ns();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Cannot open DAG file %s\n", path);
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(DagFileHeader)) {
+        printf("%s: truncated binary DAG file\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t length = info.st_size;
+    char* base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        printf("%s: mmap failed\n", path);
+        return NULL;
+    }
+    
+    DagFileHeader* header = (DagFileHeader*)base;
+    const char* problem = NULL;
+    if (memcmp(header->magic, DAG_BINARY_MAGIC, 4) != 0) problem = "not a binary DAG file";
+    else if (header->version != DAG_BINARY_VERSION) problem = "unsupported format version";
+    else if (!host_is_little_endian()) problem = "the binary DAG format is little-endian; this host is not";
+    else if (header->num_tasks < 1 || header->num_edges < 0 || header->time_unit > TIME_UNIT_NS ||
+             header->topo_count < 0 || header->topo_count > header->num_tasks ||
+             header->num_sources < 0 || header->num_sources > header->topo_count ||
+             header->num_levels < 0 || header->num_levels > header->num_tasks ||
+             header->max_priority < MIN_PRIORITY || header->max_priority > header->num_tasks + 1 ||
+             (header->has_cycles != 0) != (header->topo_count < header->num_tasks)) problem = "corrupt header";
+    
+    int n = header->num_tasks;
+    int m = header->num_edges;
+    bool has_costs = (header->flags & DAG_BINARY_EDGE_COSTS) != 0;
+    void* section[DAG_SECTIONS];
+    for (int s = 0; !problem && s < DAG_SECTIONS; s++) {
+        section[s] = NULL;
+        bool optional = (s == DAG_SEC_SUCC_COSTS || s == DAG_SEC_PRED_COSTS || s == DAG_SEC_PRED_EDGE_INDEX);
+        if (optional && !has_costs) continue;
+        size_t size, count;
+        dag_section_shape(s, n, m, &size, &count);
+        uint64_t offset = header->section[s];
+        if (offset % 8 != 0 || offset < sizeof(DagFileHeader) || offset > length ||
+            size * count > length - offset) {
+            problem = "section out of bounds";
+        } else {
+            section[s] = base + offset;
+        }
+    }
+    if (!problem &&
+        (!valid_csr(section[DAG_SEC_SUCC_OFFSETS], section[DAG_SEC_SUCC_TARGETS], n, m) ||
+         !valid_csr(section[DAG_SEC_PRED_OFFSETS], section[DAG_SEC_PRED_SOURCES], n, m))) {
+        problem = "corrupt CSR graph";
+    }
+    // The cached order seeds the ready queue, so it must hold each task at
+    // most once, every source and only sources at the front, and each task
+    // after all of its predecessors
+    if (!problem) {
+        int32_t* topo = section[DAG_SEC_TOPO_ORDER];
+        int32_t* pred_offsets = section[DAG_SEC_PRED_OFFSETS];
+        int32_t* pred_sources = section[DAG_SEC_PRED_SOURCES];
+        int* position = (int*)checked_calloc(n, sizeof(int), "DAG validation");
+        int sources = 0;
+        for (int i = 0; i < n; i++) {
+            if (pred_offsets[i] == pred_offsets[i + 1]) sources++;
+        }
+        if (sources != header->num_sources) problem = "corrupt topological order";
+        for (int k = 0; k < header->topo_count && !problem; k++) {
+            int node = topo[k];
+            if (node < 0 || node >= n || position[node] != 0 ||
+                (pred_offsets[node] == pred_offsets[node + 1]) != (k < header->num_sources)) {
+                problem = "corrupt topological order";
+                break;
+            }
+            for (int e = pred_offsets[node]; e < pred_offsets[node + 1]; e++) {
+                if (position[pred_sources[e]] == 0) problem = "corrupt topological order";
+            }
+            position[node] = k + 1;
+        }
+        free(position);
+    }
+    if (!problem) {
+        int32_t* index = section[DAG_SEC_PRED_EDGE_INDEX];
+        for (int e = 0; index && e < m; e++) {
+            if (index[e] < 0 || index[e] >= m) problem = "corrupt edge index";
+        }
+        SimTime* succ_costs = section[DAG_SEC_SUCC_COSTS];
+        SimTime* pred_costs = section[DAG_SEC_PRED_COSTS];
+        for (int e = 0; has_costs && e < m; e++) {
+            if (succ_costs[e] < 0 || pred_costs[e] < 0) problem = "negative edge cost";
+        }
+    }
+    // Priorities and levels index per-priority and per-level arrays later;
+    // tasks on a cycle have no level (-1)
+    if (!problem) {
+        SimTime* durations = section[DAG_SEC_DURATION];
+        SimTime* periods = section[DAG_SEC_PERIOD];
+        SimTime* deadlines = section[DAG_SEC_DEADLINE];
+        int32_t* priorities = section[DAG_SEC_PRIORITY];
+        int32_t* levels = section[DAG_SEC_LEVEL];
+        for (int i = 0; i < n && !problem; i++) {
+            if (durations[i] < 0 || durations[i] > LLONG_MAX / SPEED_NOMINAL ||
+                periods[i] < 0 || deadlines[i] < 0) {
+                problem = "task time out of range";
+            } else if (priorities[i] < MIN_PRIORITY || priorities[i] > header->max_priority) {
+                problem = "task priority out of range";
+            } else if (levels[i] >= header->num_levels ||
+                       levels[i] < (header->has_cycles ? -1 : 0)) {
+                problem = "task level out of range";
+            }
+        }
+    }
+    if (problem) {
+        printf("%s: %s\n", path, problem);
+        munmap(base, length);
+        return NULL;
+    }
+    
+    // Per-task records are mutable during simulation, so they live on the heap
+    DAG* dag = create_dag(n);
+    SimTime* durations = section[DAG_SEC_DURATION];
+    SimTime* periods = section[DAG_SEC_PERIOD];
+    SimTime* deadlines = section[DAG_SEC_DEADLINE];
+    int32_t* priorities = section[DAG_SEC_PRIORITY];
+    for (int i = 0; i < n; i++) {
+        add_task(dag, durations[i], periods[i]);
+        dag->tasks[i].deadline = deadlines[i];
+        dag->priority[i] = priorities[i];
+    }
+    
+    dag->mapping = base;
+    dag->mapping_size = length;
+    dag->num_edges = m;
+    dag->succ_offsets = section[DAG_SEC_SUCC_OFFSETS];
+    dag->succ_targets = section[DAG_SEC_SUCC_TARGETS];
+    dag->pred_offsets = section[DAG_SEC_PRED_OFFSETS];
+    dag->pred_sources = section[DAG_SEC_PRED_SOURCES];
+    dag->topo_order = section[DAG_SEC_TOPO_ORDER];
+    dag->level = section[DAG_SEC_LEVEL];
+    dag->topo_count = header->topo_count;
+    dag->num_sources = header->num_sources;
+    dag->num_levels = header->num_levels;
+    dag->max_priority = header->max_priority;
+    dag->has_cycles = header->has_cycles != 0;
+    if (has_costs) {
+        dag->succ_costs = section[DAG_SEC_SUCC_COSTS];
+        dag->pred_costs = section[DAG_SEC_PRED_COSTS];
+        dag->pred_edge_index = section[DAG_SEC_PRED_EDGE_INDEX];
+        dag->edge_finish = (SimTime*)checked_calloc(m, sizeof(SimTime), "CSR graph");
+        dag->edge_core = (int*)checked_calloc(m, sizeof(int), "CSR graph");
+    }
+    
+    // Times are stored in the unit the file was written in
+    TimeUnit file_unit = (TimeUnit)header->time_unit;
+    if (file_unit != time_unit) {
+        SimTime from = ticks_per_ms(file_unit), to = ticks_per_ms(time_unit);
+        for (int i = 0; i < n; i++) {
+            dag->tasks[i].duration = rescale_time(dag->tasks[i].duration, from, to);
+            dag->tasks[i].deadline = rescale_time(dag->tasks[i].deadline, from, to);
+            dag->period[i] = rescale_time(dag->period[i], from, to);
+            dag->remaining_time[i] = dag->tasks[i].duration * SPEED_NOMINAL;
+        }
+        for (int e = 0; has_costs && e < m; e++) {
+            dag->succ_costs[e] = rescale_time(dag->succ_costs[e], from, to);
+            dag->pred_costs[e] = rescale_time(dag->pred_costs[e], from, to);
+        }
+    }
+    dag_load_ms = (monotonic_ns() - started) / 1e6;
+    
+    if (!headless_mode) {
+        printf("Mapped %d tasks and %d edges from %s in %.1f ms%s\n", n, m, path, dag_load_ms,
+               dag->has_cycles ? " (WARNING: the graph has cycles)" : "");
+    }
+    return dag;
+}
+
+// Free a DAG array unless it lives in the DAG's file mapping
+void free_dag_array(DAG* dag, void* array) {
+    char* p = (char*)array;
+    if (dag->mapping && p >= (char*)dag->mapping && p < (char*)dag->mapping + dag->mapping_size) {
+        return;
+    }
+    free(array);
+}
+
+// Convert a text or DOT DAG file to the binary format and report how long
+// each takes to load
+int convert_dag_file(const char* in_path, const char* out_path) {
+    DAG* dag = load_dag_file(in_path);
+    if (!dag) return 1;
+    double text_ms = dag_load_ms;
+    bool ok = write_binary_dag(dag, out_path);
+    free_dag(dag);
+    if (!ok) return 1;
+    
+    dag = map_binary_dag(out_path);
+    if (!dag) return 1;
+    printf("converted %s to %s: tasks=%d edges=%d text_load_ms=%.3f binary_load_ms=%.3f\n",
+           in_path, out_path, dag->num_tasks, dag->num_edges, text_ms, dag_load_ms);
+    free_dag(dag);
+    return 0;
+}
+
+// Kahn's algorithm over the CSR graph. Validates acyclicity in O(V+E)
+// without recursion and caches the topological order and per-task levels
+// on the DAG so later passes do not need to traverse the graph again.
+void detect_cycles(DAG* dag) {
+    int n = dag->num_tasks;
+    int* in_degree = (int*)checked_calloc(n, sizeof(int), "cycle detection");
+    
+    free_dag_array(dag, dag->topo_order);
+    free_dag_array(dag, dag->level);
+    dag->topo_order = (int*)checked_calloc(n, sizeof(int), "topological order");
+    dag->level = (int*)checked_calloc(n, sizeof(int), "task levels");
+    
+    // Sources go first; the order array doubles as the FIFO work queue
+    int head = 0, tail = 0;
+    for (int i = 0; i < n; i++) {
+        in_degree[i] = dag->pred_offsets[i + 1] - dag->pred_offsets[i];
+        dag->level[i] = -1;
+        if (in_degree[i] == 0) {
+            dag->level[i] = 0;
+            dag->topo_order[tail++] = i;
+        }
+    }
+    dag->num_sources = tail;
+    
+    dag->num_levels = 0;
+    while (head < tail) {
+        int node = dag->topo_order[head++];
+        if (dag->level[node] + 1 > dag->num_levels) {
+            dag->num_levels = dag->level[node] + 1;
+        }
+        
+        for (int e = dag->succ_offsets[node]; e < dag->succ_offsets[node + 1]; e++) {
+            int succ = dag->succ_targets[e];
+            if (dag->level[node] + 1 > dag->level[succ]) {
+                dag->level[succ] = dag->level[node] + 1;
+            }
+            if (--in_degree[succ] == 0) {
+                dag->topo_order[tail++] = succ;
+            }
+        }
+    }
+    
+    // Tasks never released from the queue sit on (or behind) a cycle
+    dag->topo_count = tail;
+    dag->has_cycles = tail < n;
+    if (dag->has_cycles) {
+        for (int i = 0; i < n; i++) {
+            if (in_degree[i] > 0) dag->level[i] = -1;
+        }
+    }
+    
+    free(in_degree);
+    
+    if (dag->has_cycles && !headless_mode) {
+        printf("WARNING: Cycles detected in the DAG! This may cause scheduler issues.\n");
+    }
+}
+
+void display_dag(DAG* dag) {
+    if (!dag) {
+        printf("No DAG available. Please create one first.\n");
+        return;
+    }
+    
+    printf("\n===== DAG Information =====\n");
+    printf("Number of tasks: %d\n", dag->num_tasks);
+    printf("Has cycles: %s\n", dag->has_cycles ? "Yes (WARNING)" : "No");
+    printf("Depth (levels): %d\n", dag->num_levels);
+    
+    compute_upward_ranks(dag);
+    
+    printf("\nTask Details (using Rate Monotonic Scheduling):\n");
+    printf("ID | Name       | Duration | Period  | Priority | Upward Rank | Dependencies\n");
+    printf("------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < dag->num_tasks; i++) {
+        printf("%-2d | %-10s | %-8lld | %-7lld | %-8d | %-11lld | ", 
+               dag->tasks[i].id, 
+               dag->tasks[i].name, 
+               dag->tasks[i].duration, 
+               dag->period[i],
+               dag->priority[i],
+               dag->upward_rank[i]);
+        
+        if (dag->pred_offsets[i] == dag->pred_offsets[i + 1]) {
+            printf("None");
+        } else {
+            for (int e = dag->pred_offsets[i]; e < dag->pred_offsets[i + 1]; e++) {
+                printf("%d ", dag->pred_sources[e]);
+            }
+        }
+        printf("\n");
+    }
+    
+    // Only real edges are listed, so this stays readable for large DAGs
+    printf("\nAdjacency List (%d edges, task -> tasks that depend on it%s):\n", dag->num_edges,
+           dag->succ_costs ? ", transfer cost in parentheses" : "");
+    for (int i = 0; i < dag->num_tasks; i++) {
+        if (dag->succ_offsets[i] == dag->succ_offsets[i + 1]) continue;
+        printf("%2d ->", i);
+        for (int e = dag->succ_offsets[i]; e < dag->succ_offsets[i + 1]; e++) {
+            printf(" %d", dag->succ_targets[e]);
+            if (dag->succ_costs && dag->succ_costs[e] > 0) {
+                printf("(%lld)", dag->succ_costs[e]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+bool is_task_ready(DAG* dag, int task_id) {
+    // Dependencies are counted down as they complete
+    return !dag->completed[task_id] && dag->pending_deps[task_id] == 0;
+}
+
+void rq_init(ReadyQueue* rq, int num_tasks, int num_keys) {
+    if (num_keys < 1) num_keys = 1;
+    rq->num_keys = num_keys;
+    rq->count = 0;
+    
+    // Size each bitmap level from the one below until a single word remains
+    int words = (num_keys + 63) / 64;
+    rq->num_levels = 0;
+    for (int l = 0; l < RQ_MAX_LEVELS; l++) {
+        rq->bits[l] = NULL;
+    }
+    while (true) {
+        if (rq->num_levels == RQ_MAX_LEVELS) {
+            printf("Too many dispatch keys for the ready queue\n");
+            exit(1);
+        }
+        rq->bits[rq->num_levels++] = (unsigned long long*)checked_calloc(words, sizeof(unsigned long long), "ready queue");
+        if (words == 1) break;
+        words = (words + 63) / 64;
+    }
+    
+    rq->head = (int*)checked_calloc(num_keys, sizeof(int), "ready queue");
+    rq->tail = (int*)checked_calloc(num_keys, sizeof(int), "ready queue");
+    for (int k = 0; k < num_keys; k++) {
+        rq->head[k] = -1;
+        rq->tail[k] = -1;
+    }
+    rq->next = (int*)checked_calloc(num_tasks, sizeof(int), "ready queue");
+    rq->prev = (int*)checked_calloc(num_tasks, sizeof(int), "ready queue");
+    
+    rq->by_deadline = (sched_policy == POLICY_EDF);
+    rq->heap = (int*)checked_calloc(num_tasks, sizeof(int), "ready queue");
+    rq->seq = (long long*)checked_calloc(num_tasks, sizeof(long long), "ready queue");
+    rq->next_seq = 0;
+}
+
+void rq_free(ReadyQueue* rq) {
+    for (int l = 0; l < rq->num_levels; l++) {
+        free(rq->bits[l]);
+        rq->bits[l] = NULL;
+    }
+    free(rq->head);
+    free(rq->tail);
+    free(rq->next);
+    free(rq->prev);
+    free(rq->heap);
+    free(rq->seq);
+    rq->heap = NULL;
+    rq->seq = NULL;
+    rq->head = NULL;
+    rq->tail = NULL;
+    rq->next = NULL;
+    rq->prev = NULL;
+}
+
+// True when heap entry a must be dispatched before entry b
+bool heap_before(ReadyQueue* rq, DAG* dag, int a, int b) {
+    if (dag->abs_deadline[a] != dag->abs_deadline[b]) {
+        return dag->abs_deadline[a] < dag->abs_deadline[b];
+    }
+    return rq->seq[a] < rq->seq[b];
+}
+
+void heap_push(ReadyQueue* rq, DAG* dag, int task_id) {
+    rq->seq[task_id] = rq->next_seq++;
+    heap_sift_up(rq, dag, task_id);
+}
+
+void heap_sift_up(ReadyQueue* rq, DAG* dag, int task_id) {
+    int pos = rq->count++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!heap_before(rq, dag, task_id, rq->heap[parent])) break;
+        rq->heap[pos] = rq->heap[parent];
+        pos = parent;
+    }
+    rq->heap[pos] = task_id;
+}
+
+int heap_pop(ReadyQueue* rq, DAG* dag) {
+    if (rq->count == 0) {
+        return -1;
+    }
+    
+    int task_id = rq->heap[0];
+    int last = rq->heap[--rq->count];
+    
+    // Sift the last entry down from the root
+    int pos = 0;
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= rq->count) break;
+        if (child + 1 < rq->count && heap_before(rq, dag, rq->heap[child + 1], rq->heap[child])) {
+            child++;
+        }
+        if (!heap_before(rq, dag, rq->heap[child], last)) break;
+        rq->heap[pos] = rq->heap[child];
+        pos = child;
+    }
+    if (rq->count > 0) {
+        rq->heap[pos] = last;
+    }
+    
+    return task_id;
+}
+
+// Enqueue a ready task at the back of its dispatch key's bucket, so equal
+// keys are served FIFO and a preempted task goes behind its peers
+void rq_push(ReadyQueue* rq, DAG* dag, int task_id) {
+    if (rq->by_deadline) {
+        heap_push(rq, dag, task_id);
+        return;
+    }
+    
+    int key = dag->dispatch_key[task_id];
+    
+    rq->next[task_id] = -1;
+    rq->prev[task_id] = rq->tail[key];
+    if (rq->tail[key] == -1) {
+        rq->head[key] = task_id;
+        // Mark the bucket non-empty, stopping at the first word that
+        // already had a bit set
+        int index = key;
+        for (int l = 0; l < rq->num_levels; l++) {
+            unsigned long long* word = &rq->bits[l][index >> 6];
+            bool was_empty = (*word == 0);
+            *word |= 1ULL << (index & 63);
+            if (!was_empty) break;
+            index >>= 6;
+        }
+    } else {
+        rq->next[rq->tail[key]] = task_id;
+    }
+    rq->tail[key] = task_id;
+    rq->count++;
+}
+
+// Re-enqueue a task just taken from the queue ahead of its equal-key peers.
+// Under EDF the task keeps its push sequence number, which restores its
+// position among equal deadlines.
+void rq_push_front(ReadyQueue* rq, DAG* dag, int task_id) {
+    if (rq->by_deadline) {
+        heap_sift_up(rq, dag, task_id);
+        return;
+    }
+    
+    int key = dag->dispatch_key[task_id];
+    if (rq->head[key] == -1) {
+        rq_push(rq, dag, task_id);
+        return;
+    }
+    rq->prev[task_id] = -1;
+    rq->next[task_id] = rq->head[key];
+    rq->prev[rq->head[key]] = task_id;
+    rq->head[key] = task_id;
+    rq->count++;
+}
+
+// Most urgent ready task without dequeuing it, or -1 if none is ready
+int rq_peek(ReadyQueue* rq) {
+    if (rq->by_deadline) {
+        return rq->count > 0 ? rq->heap[0] : -1;
+    }
+    
+    int top = rq->num_levels - 1;
+    if (rq->bits[top][0] == 0) {
+        return -1;
+    }
+    int key = 0;
+    for (int l = top; l >= 0; l--) {
+        key = (key << 6) + __builtin_ctzll(rq->bits[l][key]);
+    }
+    return rq->head[key];
+}
+
+// Dequeue the most urgent ready task (lowest dispatch key, or earliest
+// deadline under EDF), or -1 if none is ready
+int rq_pop(ReadyQueue* rq, DAG* dag) {
+    if (rq->by_deadline) {
+        return heap_pop(rq, dag);
+    }
+    
+    int top = rq->num_levels - 1;
+    if (rq->bits[top][0] == 0) {
+        return -1;
+    }
+    
+    // Descend from the summary word to the lowest non-empty bucket
+    int key = 0;
+    for (int l = top; l >= 0; l--) {
+        key = (key << 6) + __builtin_ctzll(rq->bits[l][key]);
+    }
+    int task_id = rq->head[key];
+    
+    rq->head[key] = rq->next[task_id];
+    if (rq->head[key] == -1) {
+        rq->tail[key] = -1;
+        // Clear the bucket's bit, and summary bits whose word became empty
+        int index = key;
+        for (int l = 0; l < rq->num_levels; l++) {
+            unsigned long long* word = &rq->bits[l][index >> 6];
+            *word &= ~(1ULL << (index & 63));
+            if (*word != 0) break;
+            index >>= 6;
+        }
+    } else {
+        rq->prev[rq->head[key]] = -1;
+    }
+    rq->count--;
+    
+    return task_id;
+}
+
+// Bottom level of every task, walking the cached topological order
+// backwards so each successor is final before its predecessors read it.
+// Tasks on a cycle keep their own duration.
+void compute_upward_ranks(DAG* dag) {
+    for (int i = 0; i < dag->num_tasks; i++) {
+        dag->upward_rank[i] = dag->tasks[i].duration;
+    }
+    for (int k = dag->topo_count - 1; k >= 0; k--) {
+        int node = dag->topo_order[k];
+        SimTime longest = 0;
+        for (int e = dag->succ_offsets[node]; e < dag->succ_offsets[node + 1]; e++) {
+            int succ = dag->succ_targets[e];
+            SimTime path = dag->upward_rank[succ];
+            if (edge_costs_enabled && dag->succ_costs) {
+                path += dag->succ_costs[e];
+            }
+            if (path > longest) {
+                longest = path;
+            }
+        }
+        dag->upward_rank[node] = dag->tasks[node].duration + longest;
+    }
+}
+
+// Explicit deadline, else the period; 0 when the task has neither
+SimTime relative_deadline(DAG* dag, int task_id) {
+    return dag->tasks[task_id].deadline > 0 ? dag->tasks[task_id].deadline : dag->period[task_id];
+}
+
+// A job becomes ready: stamp its release and absolute deadline, then queue it
+void release_task(DAG* dag, int task_id, SimTime time) {
+    SimTime relative = relative_deadline(dag, task_id);
+    dag->release_time[task_id] = time;
+    dag->abs_deadline[task_id] = relative > 0 ? time + relative : LLONG_MAX;
+    rq_push(&ready_queue, dag, task_id);
+}
+
+bool release_before(DAG* dag, int a, int b) {
+    if (dag->release_time[a] != dag->release_time[b]) {
+        return dag->release_time[a] < dag->release_time[b];
+    }
+    return a < b;
+}
+
+void release_queue_push(ReleaseQueue* q, DAG* dag, int task_id) {
+    int pos = q->count++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!release_before(dag, task_id, q->heap[parent])) break;
+        q->heap[pos] = q->heap[parent];
+        pos = parent;
+    }
+    q->heap[pos] = task_id;
+}
+
+int release_queue_pop(ReleaseQueue* q, DAG* dag) {
+    int task_id = q->heap[0];
+    int last = q->heap[--q->count];
+    int pos = 0;
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= q->count) break;
+        if (child + 1 < q->count && release_before(dag, q->heap[child + 1], q->heap[child])) {
+            child++;
+        }
+        if (!release_before(dag, q->heap[child], last)) break;
+        q->heap[pos] = q->heap[child];
+        pos = child;
+    }
+    if (q->count > 0) {
+        q->heap[pos] = last;
+    }
+    return task_id;
+}
+
+// The current job of a task has all its dependencies. Queue it now, or
+// hold it until its periodic release. A periodic job keeps its nominal
+// release (job index * period) for deadlines even when its dependencies
+// finished later; a one-shot task is released when it becomes ready.
+void schedule_job(DAG* dag, int task_id) {
+    if (!periodic_mode) {
+        release_task(dag, task_id, simulation_time);
+        return;
+    }
+    
+    SimTime release = dag->jobs_done[task_id] * dag->period[task_id];
+    if (release <= simulation_time) {
+        release_task(dag, task_id, release);
+    } else {
+        dag->release_time[task_id] = release;
+        release_queue_push(&release_queue, dag, task_id);
+    }
+}
+
+// Move jobs whose release time has come into the ready queue
+void release_due_jobs(DAG* dag) {
+    while (release_queue.count > 0 &&
+           dag->release_time[release_queue.heap[0]] <= simulation_time) {
+        int task_id = release_queue_pop(&release_queue, dag);
+        release_task(dag, task_id, dag->release_time[task_id]);
+    }
+}
+
+// Job of pred whose result job `job` of succ consumes: the latest one
+// released at or before it. Equal periods pair job k with job k; a faster
+// successor reuses a slower predecessor's last result and a slower one
+// skips the results it never reads, so each task keeps its own rate.
+long long input_job(DAG* dag, int pred, int succ, long long job) {
+    if (dag->period[pred] <= 0) return 0;
+    return job * dag->period[succ] / dag->period[pred];
+}
+
+// Set up the next job of a task that just finished one: count the
+// predecessors whose input job is still outstanding (predecessors with
+// fewer jobs impose nothing) and schedule it if none are
+void start_next_job(DAG* dag, int task_id) {
+    long long job = dag->jobs_done[task_id];
+    int pending = 0;
+    for (int e = dag->pred_offsets[task_id]; e < dag->pred_offsets[task_id + 1]; e++) {
+        int pred = dag->pred_sources[e];
+        long long input = input_job(dag, pred, task_id, job);
+        if (dag->job_count[pred] > input && dag->jobs_done[pred] <= input) {
+            pending++;
+        }
+    }
+    dag->pending_deps[task_id] = pending;
+    dag->remaining_time[task_id] = dag->tasks[task_id].duration * SPEED_NOMINAL;
+    dag->job_start[task_id] = -1;
+    if (pending == 0) {
+        schedule_job(dag, task_id);
+    }
+}
+
+// Lateness bookkeeping for a job of task_id that finished at `finish`.
+// Returns the job's lateness, or LLONG_MIN if it had no deadline.
+SimTime account_deadline(DAG* dag, int task_id, SimTime finish) {
+    if (dag->abs_deadline[task_id] == LLONG_MAX) {
+        return LLONG_MIN;
+    }
+    
+    Task* task = &dag->tasks[task_id];
+    SimTime lateness = finish - dag->abs_deadline[task_id];
+    task->deadline_jobs++;
+    if (lateness > 0) {
+        task->deadline_misses++;
+        task->total_tardiness += lateness;
+    }
+    if (lateness > task->max_lateness) {
+        task->max_lateness = lateness;
+    }
+    return lateness;
+}
+
+// Jobs still unfinished when the run stopped count as misses once their
+// deadline has passed; their lateness is unknown and left out
+void account_unfinished_jobs(DAG* dag) {
+    for (int i = 0; i < dag->num_tasks; i++) {
+        Task* task = &dag->tasks[i];
+        if (dag->completed[i]) continue;
+        
+        long long overdue = 0;
+        SimTime relative = relative_deadline(dag, i);
+        if (periodic_mode && relative > 0 && dag->period[i] > 0) {
+            // Job k is due at k * period + relative deadline
+            if (simulation_time >= relative) {
+                long long last_due = (simulation_time - relative) / dag->period[i];
+                if (last_due > dag->job_count[i] - 1) last_due = dag->job_count[i] - 1;
+                overdue = last_due - dag->jobs_done[i] + 1;
+            }
+        } else if (dag->pending_deps[i] == 0 && dag->abs_deadline[i] <= simulation_time) {
+            overdue = 1;  // released one-shot job
+        }
+        
+        if (overdue > 0) {
+            task->deadline_jobs += overdue;
+            task->deadline_misses += overdue;
+        }
+    }
+}
+
+// Account a finished job and stream it to the per-job CSV
+void record_job(DAG* dag, int task_id, long long job) {
+    Task* task = &dag->tasks[task_id];
+    SimTime response = simulation_time - dag->release_time[task_id];
+    task->total_response += response;
+    if (response > task->max_response) {
+        task->max_response = response;
+    }
+    SimTime lateness = account_deadline(dag, task_id, simulation_time);
+    
+    if (job_log) {
+        if (lateness == LLONG_MIN) {
+            fprintf(job_log, "%d,%lld,%lld,%lld,%lld,%lld,,\n",
+                    task_id, job, dag->release_time[task_id], dag->job_start[task_id],
+                    simulation_time, response);
+        } else {
+            fprintf(job_log, "%d,%lld,%lld,%lld,%lld,%lld,%lld,%lld\n",
+                    task_id, job, dag->release_time[task_id], dag->job_start[task_id],
+                    simulation_time, response, dag->abs_deadline[task_id], lateness);
+        }
+    }
+}
+
+// Periodic runs release jobs up to the hyperperiod unless a horizon was set
+// explicitly (or the hyperperiod is undefined)
+SimTime effective_horizon(DAG* dag) {
+    if (periodic_mode && horizon_is_default) {
+        SimTime h = hyperperiod(dag);
+        if (h > 0) return h;
+    }
+    return simulation_horizon;
+}
+
+// Least common multiple of all non-zero periods, or 0 when there are none
+// or it does not fit in a SimTime
+SimTime hyperperiod(DAG* dag) {
+    SimTime lcm = 0;
+    for (int i = 0; i < dag->num_tasks; i++) {
+        SimTime p = dag->period[i];
+        if (p <= 0) continue;
+        if (lcm == 0) {
+            lcm = p;
+            continue;
+        }
+        
+        SimTime a = lcm, b = p;
+        while (b != 0) {
+            SimTime t = a % b;
+            a = b;
+            b = t;
+        }
+        if (lcm / a > LLONG_MAX / p) {
+            return 0;
+        }
+        lcm = lcm / a * p;
+    }
+    return lcm;
+}
+
+// Context for compare_dispatch_order(), which qsort() cannot pass along
+static DAG* key_sort_dag = NULL;
+static SimTime key_sort_max_rank = 1;
+
+// Hybrid score: critical path and RMS priority each normalised to 0..1000
+// and weighted by cp_weight percent
+long long hybrid_score(DAG* dag, int task_id, SimTime max_rank) {
+    long long cp = (long long)(dag->upward_rank[task_id] * 1000 / max_rank);
+    int levels = dag->max_priority > MIN_PRIORITY ? dag->max_priority - MIN_PRIORITY : 1;
+    long long rms = (long long)(dag->priority[task_id] - MIN_PRIORITY) * 1000 / levels;
+    return cp_weight * cp + (100 - cp_weight) * rms;
+}
+
+// Negative when task a should be dispatched before task b under the
+// active policy, zero when the policy cannot tell them apart
+int compare_dispatch_order(const void* pa, const void* pb) {
+    DAG* dag = key_sort_dag;
+    int a = *(const int*)pa;
+    int b = *(const int*)pb;
+    
+    if (sched_policy == POLICY_HYBRID) {
+        long long sa = hybrid_score(dag, a, key_sort_max_rank);
+        long long sb = hybrid_score(dag, b, key_sort_max_rank);
+        if (sa != sb) return sa > sb ? -1 : 1;
+    }
+    if (sched_policy == POLICY_EDF) {
+        // Static order only matters for the threaded engine's bands:
+        // deadline monotonic, tasks without a deadline last
+        SimTime da = relative_deadline(dag, a), db = relative_deadline(dag, b);
+        if (da == 0) da = LLONG_MAX;
+        if (db == 0) db = LLONG_MAX;
+        if (da != db) return da < db ? -1 : 1;
+    } else if (sched_policy != POLICY_RMS) {
+        if (dag->upward_rank[a] != dag->upward_rank[b]) {
+            return dag->upward_rank[a] > dag->upward_rank[b] ? -1 : 1;
+        }
+        if (sched_policy == POLICY_CRITICAL_PATH) return 0;
+    }
+    // RMS priorities already rank the periods exactly
+    if (dag->priority[a] != dag->priority[b]) {
+        return dag->priority[a] > dag->priority[b] ? -1 : 1;
+    }
+    return 0;
+}
+
+// Sort the tasks by the active policy and give each a dense dispatch key;
+// tasks the policy ranks equal share a key and are served FIFO
+void compute_dispatch_keys(DAG* dag) {
+    int n = dag->num_tasks;
+    
+    // RMS needs no sort: the priority rank is the key, highest first
+    if (sched_policy == POLICY_RMS) {
+        for (int i = 0; i < n; i++) {
+            dag->dispatch_key[i] = dag->max_priority - dag->priority[i];
+        }
+        dag->num_keys = dag->max_priority - MIN_PRIORITY + 1;
+        return;
+    }
+    
+    int* order = (int*)checked_calloc(n, sizeof(int), "dispatch order");
+    
+    key_sort_dag = dag;
+    key_sort_max_rank = 1;
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+        if (dag->upward_rank[i] > key_sort_max_rank) {
+            key_sort_max_rank = dag->upward_rank[i];
+        }
+    }
+    qsort(order, n, sizeof(int), compare_dispatch_order);
+    
+    dag->num_keys = 0;
+    for (int k = 0; k < n; k++) {
+        if (k > 0 && compare_dispatch_order(&order[k - 1], &order[k]) != 0) {
+            dag->num_keys++;
+        }
+        dag->dispatch_key[order[k]] = dag->num_keys;
+    }
+    if (n > 0) dag->num_keys++;
+    
+    free(order);
+}
+
+void reset_dag_execution(DAG* dag) {
+    for (int i = 0; i < dag->num_tasks; i++) {
+        dag->completed[i] = false;
+        dag->remaining_time[i] = dag->tasks[i].duration * SPEED_NOMINAL;
+        dag->tasks[i].finish_core = -1;
+        dag->tasks[i].last_core = -1;
+        dag->tasks[i].affinity_deadline = -1;
+        dag->tasks[i].migrations = 0;
+        dag->core_assigned[i] = -1;
+        dag->tasks[i].start_time = -1;
+        dag->tasks[i].finish_time = -1;
+        dag->tasks[i].total_response = 0;
+        dag->tasks[i].max_response = 0;
+        dag->tasks[i].deadline_jobs = 0;
+        dag->tasks[i].deadline_misses = 0;
+        dag->tasks[i].max_lateness = LLONG_MIN;
+        dag->tasks[i].total_tardiness = 0;
+        dag->pending_deps[i] = dag->pred_offsets[i + 1] - dag->pred_offsets[i];
+        dag->jobs_done[i] = 0;
+        dag->job_start[i] = -1;
+    }
+    if (dag->edge_core) {
+        for (int e = 0; e < dag->num_edges; e++) {
+            dag->edge_core[e] = -1;
+        }
+    }
+}
+
+void print_execution_trace(DAG* dag, SimTime time, int core_id, int task_id, const char* event) {
+    if (debug_mode) {
+        printf("Time %lld: Core %d - %s %s (Period: %lld, Priority: %d, %lld %s remaining)\n", 
+               time, core_id, event, dag->tasks[task_id].name, 
+               dag->period[task_id], dag->priority[task_id],
+               (dag->remaining_time[task_id] + SPEED_NOMINAL - 1) / SPEED_NOMINAL,
+               time_unit_label(time_unit));
+    }
+}
+
+SimTime trace_ns(SimTime time) {
+    return time * (1000000 / ticks_per_ms(time_unit));
+}
+
+// Append a slice to a core's trace buffer. The buffer only grows by
+// doubling, so recording is a bounds check and a store per slice.
+void trace_slice(int core_id, int task_id, long long start_ns, long long end_ns,
+                 long long overhead_ns, long long transfer_ns, TraceEnd end) {
+    TraceBuffer* buffer = &trace_buffers[core_id];
+    if (buffer->count == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        buffer->slices = (TraceSlice*)checked_realloc(buffer->slices, buffer->capacity,
+                                                      sizeof(TraceSlice), "trace buffer");
+    }
+    TraceSlice* slice = &buffer->slices[buffer->count++];
+    slice->start_ns = start_ns;
+    slice->end_ns = end_ns;
+    slice->overhead_ns = overhead_ns;
+    slice->transfer_ns = transfer_ns;
+    slice->task_id = task_id;
+    slice->end = end;
+}
+
+// Close the slice a simulated core is running at the current time
+void trace_core_slice(int core_id, TraceEnd end) {
+    Core* core = &cores[core_id];
+    trace_slice(core_id, core->current_task, trace_ns(core->slice_start), trace_ns(simulation_time),
+                trace_ns(core->slice_overhead), trace_ns(core->slice_transfer), end);
+}
+
+// Write the recorded slices as Chrome Trace Event JSON, one thread track
+// per core, for chrome://tracing or Perfetto. Each slice is a complete
+// ("X") event named after its task, with its overhead and transfer wait
+// nested inside; gaps between slices are idle time.
+bool write_chrome_trace(DAG* dag, int num_cores, const char* path) {
+    static const char* end_names[] = { "completed", "preempted", "stopped" };
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("Failed to create trace file %s.\n", path);
+        return false;
+    }
+    
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                  "\"args\":{\"name\":\"%s %s engine, %d cores, quantum %lld %s\"}}",
+            policy_name(sched_policy), engine_name(sim_engine), num_cores, quantum,
+            time_unit_label(time_unit));
+    for (int i = 0; i < num_cores; i++) {
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                      "\"args\":{\"name\":\"Core %d (%d%%)\"}}", i, i, cores[i].speed);
+        fprintf(file, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                      "\"args\":{\"sort_index\":%d}}", i, i);
+    }
+    
+    int slices = 0;
+    for (int i = 0; i < num_cores; i++) {
+        TraceBuffer* buffer = &trace_buffers[i];
+        for (int s = 0; s < buffer->count; s++) {
+            TraceSlice* slice = &buffer->slices[s];
+            int t = slice->task_id;
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"task\":%d,\"priority\":%d,"
+                          "\"period\":%lld,\"rank\":%lld,\"end\":\"%s\"}}",
+                    dag->tasks[t].name, i, slice->start_ns / 1000.0,
+                    (slice->end_ns - slice->start_ns) / 1000.0, t, dag->priority[t],
+                    dag->period[t], dag->upward_rank[t], end_names[slice->end]);
+            if (slice->overhead_ns > 0) {
+                fprintf(file, ",\n{\"name\":\"overhead\",\"cat\":\"overhead\",\"ph\":\"X\",\"pid\":1,"
+                              "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        i, slice->start_ns / 1000.0, slice->overhead_ns / 1000.0);
+            }
+            if (slice->transfer_ns > 0) {
+                fprintf(file, ",\n{\"name\":\"transfer\",\"cat\":\"transfer\",\"ph\":\"X\",\"pid\":1,"
+                              "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        i, (slice->start_ns + slice->overhead_ns) / 1000.0, slice->transfer_ns / 1000.0);
+            }
+            slices++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    
+    bool ok = (fclose(file) == 0);
+    if (!ok) {
+        printf("Failed to write trace file %s.\n", path);
+    } else if (!headless_mode) {
+        printf("Timeline trace with %d slices written to %s\n", slices, path);
+    }
+    return ok;
+}
+
+void print_progress_bar(int progress, int total) {
+    const int bar_width = 50;
+    float percentage = (float)progress / total;
+    int pos = bar_width * percentage;
+    
+    printf("[");
+    for (int i = 0; i < bar_width; i++) {
+        if (i < pos) printf("=");
+        else if (i == pos) printf(">");
+        else printf(" ");
+    }
+    printf("] %d%%\r", (int)(percentage * 100));
+    fflush(stdout);
+}
+
+// Run `elapsed` time units of work on every busy core
+void advance_running_tasks(DAG* dag, int num_cores, SimTime elapsed) {
+    for (int i = 0; i < num_cores; i++) {
+        if (!cores[i].is_idle) {
+            // Overhead is dead time: neither the task nor its slice advance
+            SimTime run = elapsed;
+            if (cores[i].overhead_remaining > 0) {
+                SimTime dead = cores[i].overhead_remaining < run ? cores[i].overhead_remaining : run;
+                cores[i].overhead_remaining -= dead;
+                cores[i].overhead_time += dead;
+                run -= dead;
+            }
+            if (cores[i].transfer_remaining > 0) {
+                SimTime wait = cores[i].transfer_remaining < run ? cores[i].transfer_remaining : run;
+                cores[i].transfer_remaining -= wait;
+                cores[i].transfer_time += wait;
+                run -= wait;
+            }
+            dag->remaining_time[cores[i].current_task] -= run * cores[i].speed;
+            cores[i].work_done += run * cores[i].speed;
+            cores[i].time_slice_remaining -= run;
+        }
+    }
+}
+
+void account_idle_time(int num_cores, SimTime elapsed) {
+    for (int i = 0; i < num_cores; i++) {
+        if (cores[i].is_idle) {
+            cores[i].total_idle_time += elapsed;  // Increment idle time counter
+        }
+    }
+}
+
+// Retire finished tasks and preempt tasks whose time slice expired
+void handle_core_events(DAG* dag, int num_cores) {
+    for (int i = 0; i < num_cores; i++) {
+        if (!cores[i].is_idle && cores[i].overhead_remaining == 0 && cores[i].transfer_remaining == 0) {
+            int task_id = cores[i].current_task;
+            
+            // Task completed
+            if (dag->remaining_time[task_id] <= 0) {
+                long long job = dag->jobs_done[task_id]++;
+                dag->core_assigned[task_id] = -1;
+                dag->tasks[task_id].finish_core = i;
+                dag->tasks[task_id].last_core = -1;
+                cores[i].tasks_finished++;
+                dag->tasks[task_id].finish_time = simulation_time;
+                completed_jobs++;
+                record_job(dag, task_id, job);
+                
+                // Successors whose current job reads this job's result and
+                // whose last dependency just finished become ready
+                for (int e = dag->succ_offsets[task_id]; e < dag->succ_offsets[task_id + 1]; e++) {
+                    int succ = dag->succ_targets[e];
+                    if (!dag->completed[succ] && input_job(dag, task_id, succ, dag->jobs_done[succ]) == job) {
+                        if (dag->edge_core) {
+                            int p = dag->pred_edge_index[e];
+                            dag->edge_finish[p] = simulation_time;
+                            dag->edge_core[p] = i;
+                        }
+                        if (--dag->pending_deps[succ] == 0) {
+                            schedule_job(dag, succ);
+                        }
+                    }
+                }
+                
+                if (dag->jobs_done[task_id] < dag->job_count[task_id]) {
+                    start_next_job(dag, task_id);
+                } else {
+                    dag->completed[task_id] = true;
+                    completed_tasks++;
+                }
+                
+                print_execution_trace(dag, simulation_time, i, task_id, "Completed");
+                if (trace_buffers) trace_core_slice(i, TRACE_COMPLETED);
+                if (!headless_mode) printf("Completed Task %d (%s) on Core %d for %lld %s (Period: %lld %s, Priority: %d)\n", 
+                       task_id, dag->tasks[task_id].name, i, dag->tasks[task_id].duration,
+                       time_unit_label(time_unit), dag->period[task_id], time_unit_label(time_unit),
+                       dag->priority[task_id]);
+                
+                cores[i].is_idle = true;
+                cores[i].current_task = -1;
+                cores[i].time_slice_remaining = 0;
+            }
+            // Time slice expired
+            else if (cores[i].time_slice_remaining <= 0) {
+                print_execution_trace(dag, simulation_time, i, task_id, "Preempted");
+                if (trace_buffers) trace_core_slice(i, TRACE_PREEMPTED);
+                
+                // Put task back into ready queue
+                dag->core_assigned[task_id] = -1;
+                dag->tasks[task_id].last_core = i;
+                rq_push(&ready_queue, dag, task_id);
+                cores[i].is_idle = true;
+                cores[i].current_task = -1;
+            }
+        }
+    }
+}
+
+// Time units core `core_id` needs for the remaining work of a task at its
+// speed. A task is retired on the first tick its remaining work drops to
+// zero or below, so it occupies a core for at least one tick.
+SimTime run_time_on_core(DAG* dag, int task_id, int core_id) {
+    SimTime run = (dag->remaining_time[task_id] + cores[core_id].speed - 1) / cores[core_id].speed;
+    return run < 1 ? 1 : run;
+}
+
+// Dead time a core spends before running a dispatched task: a context
+// switch unless it resumes the task it ran last, plus a migration if the
+// task was preempted on another core, or a cache refill if it was preempted
+// here and another task has run on the core since. A migration within a
+// cache cluster only costs a refill.
+SimTime dispatch_overhead(DAG* dag, int task_id, int core_id) {
+    Core* core = &cores[core_id];
+    int last_core = dag->tasks[task_id].last_core;
+    SimTime overhead = 0;
+    
+    if (core->last_task != task_id) {
+        overhead += context_switch_cost;
+        core->context_switches++;
+        if (last_core == core_id) {
+            overhead += cache_refill_cost;
+            core->cache_refills++;
+        }
+    }
+    if (last_core != -1 && last_core != core_id) {
+        core->migrations++;
+        dag->tasks[task_id].migrations++;
+        if (last_core / cluster_size == core_id / cluster_size) {
+            overhead += cache_refill_cost;
+            core->cluster_migrations++;
+        } else {
+            overhead += migration_cost;
+        }
+    }
+    return overhead;
+}
+
+void assign_task(DAG* dag, int task_id, int core_id) {
+    Core* core = &cores[core_id];
+    core->overhead_remaining = dispatch_overhead(dag, task_id, core_id);
+    core->transfer_remaining = 0;
+    dag->tasks[task_id].affinity_deadline = -1;
+    
+    // A job's first dispatch waits for inputs still in transit to this core
+    if (dag->job_start[task_id] == -1 && edge_costs_enabled && dag->edge_core) {
+        SimTime wait = data_ready_time(dag, task_id, core_id) - simulation_time - core->overhead_remaining;
+        if (wait > 0) core->transfer_remaining = wait;
+        for (int e = dag->pred_offsets[task_id]; e < dag->pred_offsets[task_id + 1]; e++) {
+            if (dag->pred_costs[e] > 0 && dag->edge_core[e] != -1) {
+                if (dag->edge_core[e] == core_id) core->local_inputs++;
+                else core->remote_inputs++;
+            }
+        }
+    }
+    core->current_task = task_id;
+    core->last_task = task_id;
+    core->is_idle = false;
+    core->time_slice_remaining = quantum;
+    core->slice_start = simulation_time;
+    core->slice_overhead = core->overhead_remaining;
+    core->slice_transfer = core->transfer_remaining;
+    
+    dag->core_assigned[task_id] = core_id;
+    if (dag->tasks[task_id].start_time == -1) {
+        dag->tasks[task_id].start_time = simulation_time;
+    }
+    if (dag->job_start[task_id] == -1) {
+        dag->job_start[task_id] = simulation_time;
+    }
+    
+    print_execution_trace(dag, simulation_time, core_id, task_id, "Started");
+    if (!headless_mode) printf("Executing Task %d (%s) on Core %d (Period: %lld %s, Priority: %d)\n", 
+           task_id, dag->tasks[task_id].name, core_id, dag->period[task_id],
+           time_unit_label(time_unit), dag->priority[task_id]);
+}
+
+// Earliest time a job can start on a core: each predecessor's output is
+// there when the predecessor finished, plus the edge's transfer cost if it
+// finished on another core
+SimTime data_ready_time(DAG* dag, int task_id, int core_id) {
+    SimTime ready = simulation_time;
+    if (!edge_costs_enabled || !dag->edge_core || dag->job_start[task_id] != -1) {
+        return ready;
+    }
+    for (int e = dag->pred_offsets[task_id]; e < dag->pred_offsets[task_id + 1]; e++) {
+        if (dag->edge_core[e] != -1 && dag->edge_core[e] != core_id &&
+            dag->edge_finish[e] + dag->pred_costs[e] > ready) {
+            ready = dag->edge_finish[e] + dag->pred_costs[e];
+        }
+    }
+    return ready;
+}
+
+// Idle core that finishes the task first: the fastest, unless inputs must
+// first be transferred to it; -1 if none
+int earliest_finish_core(DAG* dag, int task_id, int num_cores) {
+    int best = -1;
+    SimTime best_finish = LLONG_MAX;
+    for (int i = 0; i < num_cores; i++) {
+        if (!cores[i].is_idle) continue;
+        SimTime finish = data_ready_time(dag, task_id, i) + run_time_on_core(dag, task_id, i);
+        if (finish < best_finish) {
+            best_finish = finish;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Idle core holding a preempted task's cache: the core it last ran on, else
+// the fastest idle core of the same cluster; -1 if none
+int affinity_core(DAG* dag, int task_id, int num_cores) {
+    int last_core = dag->tasks[task_id].last_core;
+    if (last_core == -1) return -1;
+    if (cores[last_core].is_idle) return last_core;
+    
+    int first = last_core / cluster_size * cluster_size;
+    int last = first + cluster_size < num_cores ? first + cluster_size : num_cores;
+    int best = -1;
+    for (int i = first; i < last; i++) {
+        if (cores[i].is_idle && (best == -1 || cores[i].speed > cores[best].speed)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Whether a task whose inputs are still in transit to the chosen idle core
+// should rather stay queued for a busy core that would finish it earlier,
+// typically the one holding its inputs. The hold ends at the latest when
+// the inputs arrive; that instant is kept in hold_recheck so the event
+// engine stops there, just as the tick engine re-decides every tick.
+bool hold_for_locality(DAG* dag, int task_id, int idle_core, int num_cores) {
+    SimTime ready = data_ready_time(dag, task_id, idle_core);
+    if (ready <= simulation_time) return false;
+    
+    SimTime idle_finish = ready + run_time_on_core(dag, task_id, idle_core);
+    for (int i = 0; i < num_cores; i++) {
+        if (cores[i].is_idle) continue;
+        SimTime start = core_free_time(dag, i);
+        SimTime data = data_ready_time(dag, task_id, i);
+        if (data > start) start = data;
+        if (start + run_time_on_core(dag, task_id, i) < idle_finish) {
+            if (ready < hold_recheck) hold_recheck = ready;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether a preempted task should stay queued for its cache cluster: some
+// core of it frees up within affinity_wait of the first time the task was
+// held back, so the delay traded for locality is bounded
+bool hold_for_affinity(DAG* dag, int task_id, int num_cores) {
+    Task* task = &dag->tasks[task_id];
+    if (task->last_core == -1 || affinity_wait <= 0) return false;
+    if (task->affinity_deadline == -1) {
+        task->affinity_deadline = simulation_time + affinity_wait;
+    }
+    
+    int first = task->last_core / cluster_size * cluster_size;
+    int last = first + cluster_size < num_cores ? first + cluster_size : num_cores;
+    for (int i = first; i < last; i++) {
+        if (core_free_time(dag, i) <= task->affinity_deadline) return true;
+    }
+    return false;
+}
+
+// Assign ready tasks to idle cores. First idle: idle cores in index order
+// take the most urgent task. Earliest finish time: the most urgent task goes
+// to the idle core that would finish it first, counting core speed and the
+// transfer of inputs from other cores. Tasks are not held back for a faster
+// busy core, since quantum expiry and later arrivals keep it busy past any
+// estimate, except to avoid waiting for inputs: then less urgent tasks take
+// the idle cores meanwhile. On identical cores without transfer costs both
+// rules pick the same core. Affinity: a preempted task returns to its cache cluster when a
+// core there is idle, may wait a bounded time for one to free up (less
+// urgent tasks use the idle cores meanwhile), and otherwise falls back to
+// earliest finish time.
+void dispatch_ready_tasks(DAG* dag, int num_cores) {
+    if (dispatch_rule == DISPATCH_FIRST_IDLE) {
+        for (int i = 0; i < num_cores; i++) {
+            if (cores[i].is_idle) {
+                int task_id = rq_pop(&ready_queue, dag);
+                if (task_id != -1) {
+                    assign_task(dag, task_id, i);
+                }
+            }
+        }
+        return;
+    }
+    
+    int held = 0;
+    hold_recheck = LLONG_MAX;
+    while (true) {
+        int task_id = rq_peek(&ready_queue);
+        if (task_id == -1) break;
+        
+        int best = -1;
+        if (dispatch_rule == DISPATCH_AFFINITY) {
+            best = affinity_core(dag, task_id, num_cores);
+            if (best == -1 && hold_for_affinity(dag, task_id, num_cores)) {
+                affinity_held[held++] = rq_pop(&ready_queue, dag);
+                continue;
+            }
+        }
+        if (best == -1) {
+            best = earliest_finish_core(dag, task_id, num_cores);
+            if (best != -1 && hold_for_locality(dag, task_id, best, num_cores)) {
+                affinity_held[held++] = rq_pop(&ready_queue, dag);
+                continue;
+            }
+        }
+        if (best == -1) break;
+        
+        rq_pop(&ready_queue, dag);
+        assign_task(dag, task_id, best);
+        // The held tasks were judged with this core still idle; the tick
+        // engine judges them again next tick, so the event engine must too
+        if (held > 0) hold_recheck = simulation_time + 1;
+    }
+    
+    // Held tasks go back in their original order
+    while (held > 0) {
+        rq_push_front(&ready_queue, dag, affinity_held[--held]);
+    }
+}
+
+// Time at which a core completes or preempts its task, now if it is idle
+SimTime core_free_time(DAG* dag, int core_id) {
+    Core* core = &cores[core_id];
+    if (core->is_idle) return simulation_time;
+    
+    // A zero-length task completes as soon as its overhead is over
+    SimTime run = dag->remaining_time[core->current_task] > 0 ?
+                  run_time_on_core(dag, core->current_task, core_id) : 0;
+    if (core->time_slice_remaining < run) run = core->time_slice_remaining;
+    run += core->overhead_remaining + core->transfer_remaining;
+    if (run < 1) run = 1;
+    return simulation_time + run;
+}
+
+// Earliest time at which any busy core completes or preempts its task
+SimTime next_event_time(DAG* dag, int num_cores) {
+    SimTime next = LLONG_MAX;
+    for (int i = 0; i < num_cores; i++) {
+        if (!cores[i].is_idle) {
+            SimTime free_at = core_free_time(dag, i);
+            if (free_at < next) next = free_at;
+        }
+    }
+    return next;
+}
+
+// Original fixed-step loop: advances the clock one time unit per iteration
+void run_tick_engine(DAG* dag, int num_cores) {
+    while (completed_jobs < total_jobs) {
+        advance_running_tasks(dag, num_cores, 1);
+        handle_core_events(dag, num_cores);
+        release_due_jobs(dag);
+        dispatch_ready_tasks(dag, num_cores);
+        
+        // Update simulation time
+        simulation_time++;
+        account_idle_time(num_cores, 1);
+        
+        // Show progress and add small delay for visualization
+        if (!headless_mode) {
+            if (simulation_time % 20 == 0) {
+                print_progress_bar(completed_tasks, dag->num_tasks);
+            }
+            delay_ms(10);
+        }
+        
+        // Safety check - prevent infinite loops
+        if (simulation_time > run_horizon) {
+            break;
+        }
+    }
+}
+
+// Discrete-event loop: jumps straight to the next completion, quantum
+// expiry, job release or instant a held-back task may be placed instead of
+// stepping through every time unit. Dispatch decisions only change at those
+// instants, so the schedule is identical to the tick engine.
+void run_event_engine(DAG* dag, int num_cores) {
+    while (completed_jobs < total_jobs) {
+        handle_core_events(dag, num_cores);
+        release_due_jobs(dag);
+        dispatch_ready_tasks(dag, num_cores);
+        
+        SimTime next = simulation_time + 1;
+        if (completed_jobs < total_jobs) {
+            next = next_event_time(dag, num_cores);
+            if (release_queue.count > 0 && dag->release_time[release_queue.heap[0]] < next) {
+                next = dag->release_time[release_queue.heap[0]];
+            }
+            if (hold_recheck < next) {
+                next = hold_recheck;
+            }
+        }
+        // The tick engine stops after the iteration at run_horizon
+        if (next > run_horizon + 1) {
+            next = run_horizon + 1;
+        }
+        
+        SimTime elapsed = next - simulation_time;
+        advance_running_tasks(dag, num_cores, next > run_horizon ? elapsed - 1 : elapsed);
+        account_idle_time(num_cores, elapsed);
+        
+        // Show progress
+        if (!headless_mode && next / 20 != simulation_time / 20) {
+            print_progress_bar(completed_tasks, dag->num_tasks);
+        }
+        
+        simulation_time = next;
+        
+        // Safety check - prevent infinite loops
+        if (simulation_time > run_horizon) {
+            break;
+        }
+    }
+}
+
+// Monotonic wall clock in nanoseconds
+long long monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+SimTime ns_to_ticks(long long ns) {
+    return ns / (1000000LL / ticks_per_ms(time_unit));
+}
+
+// Attach the work the threaded engine runs for a task
+void set_task_payload(DAG* dag, int task_id, TaskPayload payload, void* arg) {
+    dag->tasks[task_id].payload = payload;
+    dag->tasks[task_id].payload_arg = arg;
+}
+
+// Default payload: keep the core busy for the task's duration
+void busy_wait_payload(SimTime duration) {
+    long long end = monotonic_ns() + duration * (1000000LL / ticks_per_ms(time_unit));
+    while (monotonic_ns() < end) {
+        // spin
+    }
+}
+
+#define WS_EMPTY -1
+#define WS_ABORT -2
+
+void ws_init(WsDeque* q) {
+    WsArray* a = (WsArray*)checked_calloc(1, sizeof(WsArray) + WS_INITIAL_CAPACITY * sizeof(atomic_int), "deque");
+    a->capacity = WS_INITIAL_CAPACITY;
+    a->retired = NULL;
+    atomic_init(&q->top, 0);
+    atomic_init(&q->bottom, 0);
+    atomic_init(&q->array, a);
+}
+
+void ws_free(WsDeque* q) {
+    WsArray* a = atomic_load_explicit(&q->array, memory_order_relaxed);
+    while (a) {
+        WsArray* older = a->retired;
+        free(a);
+        a = older;
+    }
+}
+
+// Owner only: double the array, copying the live range [top, bottom)
+WsArray* ws_grow(WsDeque* q, WsArray* a, long long top, long long bottom) {
+    WsArray* bigger = (WsArray*)checked_calloc(1, sizeof(WsArray) + 2 * a->capacity * sizeof(atomic_int), "deque");
+    bigger->capacity = 2 * a->capacity;
+    bigger->retired = a;
+    for (long long i = top; i < bottom; i++) {
+        int v = atomic_load_explicit(&a->slots[i & (a->capacity - 1)], memory_order_relaxed);
+        atomic_store_explicit(&bigger->slots[i & (bigger->capacity - 1)], v, memory_order_relaxed);
+    }
+    atomic_store_explicit(&q->array, bigger, memory_order_release);
+    return bigger;
+}
+
+// Owner only
+void ws_push(WsDeque* q, int task_id) {
+    long long b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+    long long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    WsArray* a = atomic_load_explicit(&q->array, memory_order_relaxed);
+    if (b - t > a->capacity - 1) {
+        a = ws_grow(q, a, t, b);
+    }
+    atomic_store_explicit(&a->slots[b & (a->capacity - 1)], task_id, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+}
+
+// Owner only: newest task first, WS_EMPTY if none
+int ws_take(WsDeque* q) {
+    long long b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+    WsArray* a = atomic_load_explicit(&q->array, memory_order_relaxed);
+    atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long t = atomic_load_explicit(&q->top, memory_order_relaxed);
+    
+    if (t > b) {
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+        return WS_EMPTY;
+    }
+    int task_id = atomic_load_explicit(&a->slots[b & (a->capacity - 1)], memory_order_relaxed);
+    if (t == b) {
+        // Last element: race against thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            task_id = WS_EMPTY;
+        }
+        atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+    }
+    return task_id;
+}
+
+// Any core: oldest task first, WS_EMPTY if none or WS_ABORT on a lost race
+int ws_steal(WsDeque* q) {
+    long long t = atomic_load_explicit(&q->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+    if (t >= b) {
+        return WS_EMPTY;
+    }
+    WsArray* a = atomic_load_explicit(&q->array, memory_order_acquire);
+    int task_id = atomic_load_explicit(&a->slots[t & (a->capacity - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return WS_ABORT;
+    }
+    return task_id;
+}
+
+bool ws_is_empty(WsDeque* q) {
+    long long t = atomic_load_explicit(&q->top, memory_order_relaxed);
+    long long b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+    return b <= t;
+}
+
+// Worker side of an event ring: publish one record, or count it as dropped
+// when the drainer has fallen a full ring behind
+void event_record(EventRing* ring, long long time_ns, int task_id, int core_id, EventType type) {
+    unsigned long long head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned long long tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail == EVENT_RING_SIZE) {
+        ring->dropped++;
+        return;
+    }
+    EventRecord* record = &ring->slots[head & (EVENT_RING_SIZE - 1)];
+    record->time_ns = (uint64_t)time_ns;
+    record->task_id = task_id;
+    record->core_id = (uint16_t)core_id;
+    record->type = (uint8_t)type;
+    record->reserved = 0;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// Drainer side: copy out every published record, returning how many
+int event_ring_drain(EventRing* ring, EventRecord* out) {
+    unsigned long long tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned long long head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    int count = (int)(head - tail);
+    for (int i = 0; i < count; i++) {
+        out[i] = ring->slots[(tail + i) & (EVENT_RING_SIZE - 1)];
+    }
+    atomic_store_explicit(&ring->tail, head, memory_order_release);
+    return count;
+}
+
+// Print a record in the format of print_execution_trace
+void print_event_record(DAG* dag, const EventRecord* record) {
+    static const char* event_names[] = { "Started", "Completed", "Stolen" };
+    int task_id = record->task_id;
+    SimTime remaining = (record->type == EVENT_COMPLETED) ? 0 : dag->tasks[task_id].duration;
+    printf("Time %lld: Core %d - %s %s (Period: %lld, Priority: %d, %lld %s remaining)\n",
+           ns_to_ticks((long long)record->time_ns), record->core_id, event_names[record->type],
+           dag->tasks[task_id].name, dag->period[task_id], dag->priority[task_id],
+           remaining, time_unit_label(time_unit));
+}
+
+int compare_event_records(const void* pa, const void* pb) {
+    const EventRecord* a = (const EventRecord*)pa;
+    const EventRecord* b = (const EventRecord*)pb;
+    if (a->time_ns != b->time_ns) return (a->time_ns > b->time_ns) - (a->time_ns < b->time_ns);
+    if (a->core_id != b->core_id) return a->core_id - b->core_id;
+    return a->type - b->type;
+}
+
+void* event_drainer(void* arg) {
+    EventLogger* logger = (EventLogger*)arg;
+    EventRecord batch[EVENT_RING_SIZE];
+    struct timespec pause = { 0, 100000 };
+    
+    for (;;) {
+        // Read the flag before draining so the last pass sees every record
+        bool stopping = atomic_load(&logger->stop);
+        int drained = 0;
+        for (int i = 0; i < logger->num_rings; i++) {
+            int count = event_ring_drain(&logger->rings[i], batch);
+            if (count == 0) continue;
+            if (logger->file) {
+                fwrite(batch, sizeof(EventRecord), count, logger->file);
+            }
+            if (debug_mode) {
+                if (logger->debug_count + count > logger->debug_capacity) {
+                    logger->debug_capacity = 2 * (logger->debug_count + count);
+                    logger->debug_records = (EventRecord*)checked_realloc(logger->debug_records,
+                        logger->debug_capacity, sizeof(EventRecord), "debug trace");
+                }
+                memcpy(logger->debug_records + logger->debug_count, batch, count * sizeof(EventRecord));
+                logger->debug_count += count;
+            }
+            logger->records += count;
+            drained += count;
+        }
+        if (stopping) break;
+        if (drained == 0) nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+// Allocate one ring per core and start the drainer. The log header is
+// rewritten with the final counts when the logger stops.
+bool start_event_logger(EventLogger* logger, DAG* dag, int num_cores) {
+    logger->file = NULL;
+    if (event_log_path[0] != '\0') {
+        logger->file = fopen(event_log_path, "wb");
+        if (!logger->file) {
+            printf("Failed to create event log %s.\n", event_log_path);
+            return false;
+        }
+        EventLogHeader header = { EVENT_LOG_MAGIC, EVENT_LOG_VERSION, num_cores, dag->num_tasks, 0, 0 };
+        fwrite(&header, sizeof(header), 1, logger->file);
+    }
+    logger->rings = (EventRing*)checked_calloc(num_cores, sizeof(EventRing), "event rings");
+    logger->num_rings = num_cores;
+    logger->dag = dag;
+    logger->records = 0;
+    logger->debug_records = NULL;
+    logger->debug_count = 0;
+    logger->debug_capacity = 0;
+    atomic_init(&logger->stop, false);
+    if (pthread_create(&logger->thread, NULL, event_drainer, logger) != 0) {
+        printf("Failed to create event log drainer thread\n");
+        exit(1);
+    }
+    return true;
+}
+
+// Stop the drainer once the workers are joined and report dropped records
+void stop_event_logger(EventLogger* logger) {
+    atomic_store(&logger->stop, true);
+    pthread_join(logger->thread, NULL);
+    
+    if (logger->debug_count > 0) {
+        qsort(logger->debug_records, logger->debug_count, sizeof(EventRecord), compare_event_records);
+        for (size_t i = 0; i < logger->debug_count; i++) {
+            print_event_record(logger->dag, &logger->debug_records[i]);
+        }
+    }
+    free(logger->debug_records);
+    logger->debug_records = NULL;
+    
+    long long dropped = 0;
+    for (int i = 0; i < logger->num_rings; i++) {
+        dropped += logger->rings[i].dropped;
+    }
+    if (logger->file) {
+        EventLogHeader header = { EVENT_LOG_MAGIC, EVENT_LOG_VERSION, logger->num_rings,
+                                  logger->dag->num_tasks, logger->records, (uint64_t)dropped };
+        rewind(logger->file);
+        fwrite(&header, sizeof(header), 1, logger->file);
+        if (fclose(logger->file) != 0) {
+            printf("Failed to write event log %s.\n", event_log_path);
+        } else if (!headless_mode) {
+            printf("Event log: %llu records written to %s, %lld dropped\n",
+                   logger->records, event_log_path, dropped);
+        }
+    }
+    if (dropped > 0 && headless_mode) {
+        fprintf(stderr, "event log: %lld records dropped\n", dropped);
+    }
+    free(logger->rings);
+    logger->rings = NULL;
+}
+
+// Print a binary event log as execution trace lines in time order. The log
+// holds task ids only, so names, periods and priorities come from `dag`,
+// which must be the DAG the log was recorded for.
+int decode_event_log(DAG* dag, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("Cannot open event log %s\n", path);
+        return 1;
+    }
+    EventLogHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, EVENT_LOG_MAGIC, 4) != 0 || header.version != EVENT_LOG_VERSION) {
+        printf("%s: not an event log\n", path);
+        fclose(file);
+        return 1;
+    }
+    if (header.num_tasks != dag->num_tasks) {
+        printf("%s: recorded for %d tasks, but the DAG has %d\n", path, header.num_tasks, dag->num_tasks);
+        fclose(file);
+        return 1;
+    }
+    
+    size_t count = (size_t)header.records;
+    EventRecord* records = (EventRecord*)checked_calloc(count ? count : 1, sizeof(EventRecord), "event records");
+    size_t got = fread(records, sizeof(EventRecord), count, file);
+    fclose(file);
+    if (got != count) {
+        printf("%s: truncated, %zu of %zu records\n", path, got, count);
+        free(records);
+        return 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].task_id < 0 || records[i].task_id >= dag->num_tasks ||
+            records[i].core_id >= header.num_cores || records[i].type > EVENT_STOLEN) {
+            printf("%s: record %zu is invalid\n", path, i);
+            free(records);
+            return 1;
+        }
+    }
+    
+    qsort(records, count, sizeof(EventRecord), compare_event_records);
+    for (size_t i = 0; i < count; i++) {
+        print_event_record(dag, &records[i]);
+    }
+    printf("%zu records on %d cores, %llu dropped\n", count, header.num_cores,
+           (unsigned long long)header.dropped);
+    free(records);
+    return 0;
+}
+
+// Map a dispatch key onto a deque band; higher band = more urgent
+int priority_band(DAG* dag, int task_id) {
+    long long key = dag->dispatch_key[task_id];
+    int band = WS_BANDS - 1 - (int)(key * WS_BANDS / dag->num_keys);
+    if (band < 0) band = 0;
+    return band;
+}
+
+// Take from this core's own deques, highest band first
+int take_own_task(ThreadedEngine* engine, int core_id) {
+    WsDeque* own = &engine->deques[core_id * WS_BANDS];
+    for (int band = WS_BANDS - 1; band >= 0; band--) {
+        int task_id = ws_take(&own[band]);
+        if (task_id >= 0) return task_id;
+    }
+    return WS_EMPTY;
+}
+
+// Steal from the highest non-empty band over all other cores, starting at
+// the next core so thieves spread over victims
+int steal_task(ThreadedEngine* engine, int core_id) {
+    for (int band = WS_BANDS - 1; band >= 0; band--) {
+        for (int k = 1; k < engine->num_cores; k++) {
+            int victim = (core_id + k) % engine->num_cores;
+            WsDeque* q = &engine->deques[victim * WS_BANDS + band];
+            if (ws_is_empty(q)) continue;
+            
+            int task_id = ws_steal(q);
+            if (task_id >= 0) return task_id;
+        }
+    }
+    return WS_EMPTY;
+}
+
+void* threaded_worker(void* arg) {
+    Worker* worker = (Worker*)arg;
+    ThreadedEngine* engine = worker->engine;
+    DAG* dag = engine->dag;
+    Core* core = &cores[worker->core_id];
+    WsDeque* own = &engine->deques[worker->core_id * WS_BANDS];
+    EventRing* ring = engine->rings ? &engine->rings[worker->core_id] : NULL;
+    
+    while (atomic_load(&engine->in_flight) > 0) {
+        int task_id = take_own_task(engine, worker->core_id);
+        
+        if (task_id < 0) {
+            // Out of local work: steal. Only the successful attempt (victim
+            // scan and CAS) is timed, not the idle spinning before it.
+            long long attempt_start = 0;
+            int attempts = 0;
+            while (task_id < 0 && atomic_load(&engine->in_flight) > 0) {
+                attempt_start = monotonic_ns();
+                task_id = steal_task(engine, worker->core_id);
+                if (task_id < 0) {
+                    core->failed_steals++;
+                    if (++attempts % 64 == 0) sched_yield();
+                }
+            }
+            if (task_id < 0) break;
+            long long stolen = monotonic_ns();
+            core->steals++;
+            core->steal_latency_ns += stolen - attempt_start;
+            if (ring) event_record(ring, stolen - engine->epoch_ns, task_id, worker->core_id, EVENT_STOLEN);
+        }
+        
+        long long start = monotonic_ns();
+        if (ring) event_record(ring, start - engine->epoch_ns, task_id, worker->core_id, EVENT_STARTED);
+        Task* task = &dag->tasks[task_id];
+        dag->core_assigned[task_id] = worker->core_id;
+        if (task->payload) {
+            task->payload(task_id, task->payload_arg);
+        } else {
+            busy_wait_payload(task->duration * SPEED_NOMINAL / core->speed);
+        }
+        long long finish = monotonic_ns();
+        if (ring) event_record(ring, finish - engine->epoch_ns, task_id, worker->core_id, EVENT_COMPLETED);
+        
+        task->start_time = ns_to_ticks(start - engine->epoch_ns);
+        task->finish_time = ns_to_ticks(finish - engine->epoch_ns);
+        worker->busy_time += ns_to_ticks(finish - start);
+        core->tasks_run++;
+        core->tasks_finished++;
+        core->work_done += task->duration * SPEED_NOMINAL;
+        task->finish_core = worker->core_id;
+        dag->remaining_time[task_id] = 0;
+        dag->completed[task_id] = true;
+        dag->core_assigned[task_id] = -1;
+        
+        if (trace_buffers) {
+            trace_slice(worker->core_id, task_id, start - engine->epoch_ns, finish - engine->epoch_ns,
+                        0, 0, TRACE_COMPLETED);
+        }
+        account_deadline(dag, task_id, task->finish_time);
+        
+        // Successors released by this completion go onto this core's deques
+        for (int e = dag->succ_offsets[task_id]; e < dag->succ_offsets[task_id + 1]; e++) {
+            int succ = dag->succ_targets[e];
+            if (__atomic_sub_fetch(&dag->pending_deps[succ], 1, __ATOMIC_ACQ_REL) == 0) {
+                SimTime relative = relative_deadline(dag, succ);
+                dag->release_time[succ] = task->finish_time;
+                dag->abs_deadline[succ] = relative > 0 ? task->finish_time + relative : LLONG_MAX;
+                atomic_fetch_add(&engine->in_flight, 1);
+                ws_push(&own[priority_band(dag, succ)], succ);
+            }
+        }
+        __atomic_add_fetch(&completed_tasks, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&completed_jobs, 1, __ATOMIC_RELAXED);
+        atomic_fetch_sub(&engine->in_flight, 1);
+    }
+    
+    return NULL;
+}
+
+// Real execution: one worker thread per core runs task payloads as their
+// dependencies complete. Each core owns a Chase-Lev deque per priority band;
+// a released successor goes onto the deque of the core that finished its
+// last predecessor and idle cores steal from the highest non-empty band.
+// Tasks are not preempted. Start and finish times are measured on the
+// monotonic clock and stored in the current time unit. Workers never print:
+// with an event log or debug mode their events go through per-core rings
+// to a drainer thread.
+void run_threaded_engine(DAG* dag, int num_cores) {
+    ThreadedEngine engine;
+    engine.dag = dag;
+    engine.num_cores = num_cores;
+    engine.rings = NULL;
+    EventLogger logger;
+    if ((event_log_path[0] != '\0' || debug_mode) && start_event_logger(&logger, dag, num_cores)) {
+        engine.rings = logger.rings;
+    }
+    engine.deques = (WsDeque*)checked_calloc((size_t)num_cores * WS_BANDS, sizeof(WsDeque), "deques");
+    for (int i = 0; i < num_cores * WS_BANDS; i++) {
+        ws_init(&engine.deques[i]);
+    }
+    
+    // Deal the initially ready tasks out round-robin in RMS order
+    int dealt = 0;
+    for (int task_id = rq_pop(&ready_queue, dag); task_id != -1; task_id = rq_pop(&ready_queue, dag)) {
+        int core_id = dealt++ % num_cores;
+        ws_push(&engine.deques[core_id * WS_BANDS + priority_band(dag, task_id)], task_id);
+    }
+    atomic_init(&engine.in_flight, dealt);
+    
+    pthread_t* threads = (pthread_t*)checked_calloc(num_cores, sizeof(pthread_t), "worker threads");
+    Worker* workers = (Worker*)checked_calloc(num_cores, sizeof(Worker), "worker threads");
+    
+    engine.epoch_ns = monotonic_ns();
+    for (int i = 0; i < num_cores; i++) {
+        workers[i].engine = &engine;
+        workers[i].core_id = i;
+        workers[i].busy_time = 0;
+        if (pthread_create(&threads[i], NULL, threaded_worker, &workers[i]) != 0) {
+            printf("Failed to create worker thread for core %d\n", i);
+            exit(1);
+        }
+    }
+    for (int i = 0; i < num_cores; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    simulation_time = ns_to_ticks(monotonic_ns() - engine.epoch_ns);
+    if (engine.rings) {
+        stop_event_logger(&logger);
+    }
+    
+    for (int i = 0; i < num_cores; i++) {
+        cores[i].total_idle_time = simulation_time - workers[i].busy_time;
+    }
+    
+    for (int i = 0; i < num_cores * WS_BANDS; i++) {
+        ws_free(&engine.deques[i]);
+    }
+    free(engine.deques);
+    free(threads);
+    free(workers);
+}
+
+void print_work_stealing_stats(int num_cores) {
+    printf("\n===== Work-Stealing Statistics =====\n");
+    printf("Core | Tasks Run | Steals | Failed Steals | Avg Steal Latency (ns)\n");
+    printf("----------------------------------------------------------------\n");
+    
+    for (int i = 0; i < num_cores; i++) {
+        double latency_ns = cores[i].steals > 0
+            ? (double)cores[i].steal_latency_ns / cores[i].steals : 0.0;
+        printf("%-4d | %-9d | %-6d | %-13lld | %.0f\n",
+               i, cores[i].tasks_run, cores[i].steals, cores[i].failed_steals, latency_ns);
+    }
+}
+
+void simulate_hybrid_scheduler(DAG* dag, int num_cores) {
+    if (!headless_mode) {
+        printf("Running Hybrid DAG-based Scheduler with %s (%s engine)...\n",
+               policy_title(sched_policy), engine_name(sim_engine));
     }
-    printf("] %d%%\r", (int)(percentage * 100));
-    fflush(stdout);
-}
-
-void simulate_hybrid_scheduler(DAG* dag, int num_cores) {
-    printf("Running Hybrid DAG-based Scheduler with Rate Monotonic Scheduling...\n");
     
     // Initialize
     reset_dag_execution(dag);
+    compute_upward_ranks(dag);
+    compute_dispatch_keys(dag);
     simulation_time = 0;
     completed_tasks = 0;
+    completed_jobs = 0;
+    
+    // Periodic runs release jobs up to the hyperperiod unless a horizon was
+    // set explicitly; the threaded engine runs every task once
+    bool saved_periodic = periodic_mode;
+    if (sim_engine == ENGINE_THREADED) {
+        periodic_mode = false;
+    }
+    run_horizon = effective_horizon(dag);
+    if (periodic_mode && horizon_is_default && run_horizon == simulation_horizon && !headless_mode) {
+        printf("Hyperperiod too large or undefined; using the %lld %s horizon.\n",
+               simulation_horizon, time_unit_label(time_unit));
+    }
+    total_jobs = 0;
+    for (int i = 0; i < dag->num_tasks; i++) {
+        SimTime p = dag->period[i];
+        dag->job_count[i] = (periodic_mode && p > 0) ? (run_horizon + p - 1) / p : 1;
+        if (dag->job_count[i] < 1) dag->job_count[i] = 1;
+        total_jobs += dag->job_count[i];
+    }
+    
+    job_log = NULL;
+    if (periodic_mode && job_csv_path[0] != '\0') {
+        job_log = (strcmp(job_csv_path, "-") == 0) ? stdout : fopen(job_csv_path, "w");
+        if (!job_log) {
+            printf("Failed to create job CSV file %s.\n", job_csv_path);
+        } else {
+            fprintf(job_log, "Task ID,Job,Release,Start,Finish,Response,Deadline,Lateness\n");
+        }
+    }
     
-    // Allocate and initialize cores
-    cores = (Core*)malloc(num_cores * sizeof(Core));
+    // Allocate and initialize cores; they are kept after the run so the
+    // utilization figures can still be exported
+    free(cores);
+    cores = (Core*)checked_calloc(num_cores, sizeof(Core), "cores");
     for (int i = 0; i < num_cores; i++) {
         cores[i].core_id = i;
-        cores[i].current_task = NULL;
+        cores[i].current_task = -1;
         cores[i].time_slice_remaining = 0;
         cores[i].is_idle = true;
         cores[i].total_idle_time = 0;  // Initialize idle time counter
+        cores[i].speed = (i < num_core_speeds) ? core_speed_config[i] : SPEED_NOMINAL;
+        cores[i].work_done = 0;
+        cores[i].tasks_finished = 0;
+        cores[i].last_task = -1;
+        cores[i].overhead_remaining = 0;
+        cores[i].overhead_time = 0;
+        cores[i].context_switches = 0;
+        cores[i].migrations = 0;
+        cores[i].cluster_migrations = 0;
+        cores[i].cache_refills = 0;
+        cores[i].transfer_remaining = 0;
+        cores[i].transfer_time = 0;
+        cores[i].remote_inputs = 0;
+        cores[i].local_inputs = 0;
+    }
+    
+    // Seed the ready queue with the sources cached at the front of the
+    // topological order
+    rq_init(&ready_queue, dag->num_tasks, dag->num_keys);
+    release_queue.heap = (int*)checked_calloc(dag->num_tasks, sizeof(int), "release queue");
+    release_queue.count = 0;
+    affinity_held = (int*)checked_calloc(dag->num_tasks, sizeof(int), "affinity list");
+    if (trace_path[0] != '\0') {
+        trace_buffers = (TraceBuffer*)checked_calloc(num_cores, sizeof(TraceBuffer), "trace buffers");
+    }
+    for (int k = 0; k < dag->num_sources; k++) {
+        schedule_job(dag, dag->topo_order[k]);
+    }
+    
+    // Main simulation loop
+    if (sim_engine == ENGINE_TICK) {
+        run_tick_engine(dag, num_cores);
+    } else if (sim_engine == ENGINE_THREADED) {
+        run_threaded_engine(dag, num_cores);
+    } else {
+        run_event_engine(dag, num_cores);
+    }
+    if (sim_engine != ENGINE_THREADED) {
+        account_unfinished_jobs(dag);
+        for (int i = 0; trace_buffers && i < num_cores; i++) {
+            if (!cores[i].is_idle) trace_core_slice(i, TRACE_STOPPED);
+        }
+    }
+    
+    if (output_format == OUTPUT_TABLE) {
+        if (sim_engine == ENGINE_THREADED && completed_tasks < dag->num_tasks) {
+            printf("\nExecution stopped: remaining tasks can never become ready (cycle?).\n");
+        } else if (sim_engine != ENGINE_THREADED && simulation_time > run_horizon) {
+            printf("\nSimulation exceeded time limit. Possible deadlock or very long tasks.\n");
+        }
+    }
+    
+    switch (output_format) {
+        case OUTPUT_SUMMARY:
+            print_simulation_summary(dag, num_cores);
+            break;
+        case OUTPUT_CSV:
+            write_task_results_csv(stdout, dag);
+            break;
+        case OUTPUT_NONE:
+            break;
+        default:
+            print_simulation_results(dag, num_cores);
+            break;
+    }
+    
+    if (trace_buffers) {
+        write_chrome_trace(dag, num_cores, trace_path);
+        for (int i = 0; i < num_cores; i++) {
+            free(trace_buffers[i].slices);
+        }
+        free(trace_buffers);
+        trace_buffers = NULL;
+    }
+    
+    // Clean up
+    rq_free(&ready_queue);
+    free(release_queue.heap);
+    release_queue.heap = NULL;
+    free(affinity_held);
+    affinity_held = NULL;
+    if (job_log && job_log != stdout) {
+        fclose(job_log);
+    }
+    job_log = NULL;
+    periodic_mode = saved_periodic;
+}
+
+// Turnaround of a task: first start to last finish. In periodic mode that
+// spans every job of the task, so the mean job response time (release to
+// finish) is used instead.
+double task_turnaround(DAG* dag, int task_id) {
+    Task* task = &dag->tasks[task_id];
+    if (periodic_mode) {
+        return dag->jobs_done[task_id] > 0 ? (double)task->total_response / dag->jobs_done[task_id] : 0.0;
+    }
+    return (double)(task->finish_time - task->start_time);
+}
+
+// Mean turnaround over the tasks, or over the completed jobs in periodic mode
+double average_turnaround(DAG* dag) {
+    double total = 0.0;
+    for (int i = 0; i < dag->num_tasks; i++) {
+        total += periodic_mode ? (double)dag->tasks[i].total_response : task_turnaround(dag, i);
+    }
+    long long count = periodic_mode ? completed_jobs : dag->num_tasks;
+    return count > 0 ? total / count : 0.0;
+}
+
+void print_simulation_results(DAG* dag, int num_cores) {
+    printf("\nSimulation completed in %lld time units (%s)\n", simulation_time, time_unit_label(time_unit));
+    
+    // Print results
+    printf("\n===== Execution Results with %s =====\n", policy_title(sched_policy));
+    printf("ID | Name       | Duration | Period  | Priority | Start | Finish | %s | Core\n",
+           periodic_mode ? "Avg Resp  " : "Turnaround");
+    printf("--------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < dag->num_tasks; i++) {
+        Task* task = &dag->tasks[i];
+        printf("%-2d | %-10s | %-8lld | %-7lld | %-8d | %-5lld | %-6lld | ",
+               task->id, task->name, task->duration, dag->period[i], dag->priority[i],
+               task->start_time, task->finish_time);
+        if (periodic_mode) printf("%-10.2f | ", task_turnaround(dag, i));
+        else printf("%-10lld | ", task->finish_time - task->start_time);
+        if (task->finish_core >= 0) printf("%d\n", task->finish_core);
+        else printf("-\n");
+    }
+    
+    printf("\nAverage %s Time: %.2f\n", periodic_mode ? "Job Response" : "Turnaround", average_turnaround(dag));
+    print_slow_core_tasks(dag, num_cores);
+
+    printf("\n===== Core Utilization Statistics =====\n");
+    printf("Core | Busy Time | Idle Time | Utilization %% | Speed %% | Work Done | Tasks Finished\n");
+    printf("-------------------------------------------------------------------------------\n");
+
+    float total_utilization = 0.0;
+    for (int i = 0; i < num_cores; i++) {
+        SimTime busy_time = simulation_time - cores[i].total_idle_time;
+        float utilization = (double)busy_time / simulation_time * 100.0;
+        total_utilization += utilization;
+        char percent[16];
+        snprintf(percent, sizeof(percent), "%.2f%%", utilization);
+        
+        printf("%-4d | %-9lld | %-9lld | %-13s | %-7d | %-9lld | %d\n",
+               i, busy_time, cores[i].total_idle_time, percent, cores[i].speed,
+               cores[i].work_done / SPEED_NOMINAL, cores[i].tasks_finished);
+    }
+
+    printf("\nAverage Core Utilization: %.2f%%\n", total_utilization / num_cores);
+    
+    if (sim_engine != ENGINE_THREADED &&
+        (context_switch_cost > 0 || migration_cost > 0 || cache_refill_cost > 0)) {
+        print_scheduling_overhead(num_cores);
+    }
+    if (sim_engine != ENGINE_THREADED) {
+        print_migrations(dag, num_cores);
+        if (edge_costs_enabled && dag->edge_core) {
+            print_data_transfers(dag, num_cores);
+        }
+    }
+    
+    print_deadline_metrics(dag);
+    
+    if (periodic_mode) {
+        print_job_statistics(dag);
+    }
+    
+    print_utilization_bounds(dag, num_cores);
+    
+    if (sim_engine == ENGINE_THREADED) {
+        print_work_stealing_stats(num_cores);
+    }
+}
+
+void sum_deadline_metrics(DAG* dag, DeadlineTotals* totals) {
+    memset(totals, 0, sizeof(*totals));
+    totals->max_lateness = LLONG_MIN;
+    totals->max_priority = dag->max_priority;
+    totals->jobs_by_priority = (long long*)checked_calloc(dag->max_priority + 1, sizeof(long long), "deadline metrics");
+    totals->misses_by_priority = (long long*)checked_calloc(dag->max_priority + 1, sizeof(long long), "deadline metrics");
+    for (int i = 0; i < dag->num_tasks; i++) {
+        Task* task = &dag->tasks[i];
+        totals->deadline_jobs += task->deadline_jobs;
+        totals->misses += task->deadline_misses;
+        totals->total_tardiness += task->total_tardiness;
+        if (task->max_lateness > totals->max_lateness) {
+            totals->max_lateness = task->max_lateness;
+        }
+        totals->jobs_by_priority[dag->priority[i]] += task->deadline_jobs;
+        totals->misses_by_priority[dag->priority[i]] += task->deadline_misses;
+    }
+}
+
+void free_deadline_totals(DeadlineTotals* totals) {
+    free(totals->jobs_by_priority);
+    free(totals->misses_by_priority);
+    totals->jobs_by_priority = NULL;
+    totals->misses_by_priority = NULL;
+}
+
+// Deadline misses, lateness and tardiness per task, then per RMS priority.
+// Lateness is finish minus absolute deadline, so negative means early.
+void print_deadline_metrics(DAG* dag) {
+    DeadlineTotals totals;
+    sum_deadline_metrics(dag, &totals);
+    
+    printf("\n===== Real-Time Metrics =====\n");
+    printf("ID | Name       | Deadline | Jobs     | Misses   | Max Lateness | Total Tardiness\n");
+    printf("-------------------------------------------------------------------------------\n");
+    for (int i = 0; i < dag->num_tasks; i++) {
+        Task* task = &dag->tasks[i];
+        SimTime deadline = relative_deadline(dag, i);
+        if (deadline <= 0) {
+            printf("%-2d | %-10s | %-8s | %-8s | %-8s | %-12s | %s\n",
+                   task->id, task->name, "none", "-", "-", "-", "-");
+            continue;
+        }
+        printf("%-2d | %-10s | %-8lld | %-8lld | %-8lld | ", task->id, task->name, deadline,
+               task->deadline_jobs, task->deadline_misses);
+        if (task->deadline_jobs > 0) printf("%-12lld | ", task->max_lateness);
+        else printf("%-12s | ", "-");
+        printf("%lld\n", task->total_tardiness);
+    }
+    
+    printf("\nDeadline misses: %lld of %lld jobs (%.2f%%)\n", totals.misses, totals.deadline_jobs,
+           totals.deadline_jobs > 0 ? 100.0 * totals.misses / totals.deadline_jobs : 0.0);
+    if (totals.deadline_jobs > 0) {
+        printf("Maximum lateness: %lld %s\n", totals.max_lateness, time_unit_label(time_unit));
+    }
+    printf("Total tardiness: %lld %s\n", totals.total_tardiness, time_unit_label(time_unit));
+    
+    printf("\nPriority | Jobs     | Misses   | Miss Ratio\n");
+    printf("--------------------------------------------\n");
+    for (int p = totals.max_priority; p >= MIN_PRIORITY; p--) {
+        if (totals.jobs_by_priority[p] == 0) continue;
+        printf("%-8d | %-8lld | %-8lld | %.2f%%\n", p, totals.jobs_by_priority[p], totals.misses_by_priority[p],
+               100.0 * totals.misses_by_priority[p] / totals.jobs_by_priority[p]);
+    }
+    free_deadline_totals(&totals);
+}
+
+// Per-task aggregates of a periodic run; per-job records go to the job CSV
+void print_job_statistics(DAG* dag) {
+    printf("\n===== Periodic Jobs (horizon %lld %s, %lld of %lld jobs completed) =====\n",
+           run_horizon, time_unit_label(time_unit), completed_jobs, total_jobs);
+    printf("ID | Name       | Period  | Jobs     | Completed | Avg Response | Max Response\n");
+    printf("-----------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < dag->num_tasks; i++) {
+        Task* task = &dag->tasks[i];
+        double avg_response = dag->jobs_done[i] > 0 ? (double)task->total_response / dag->jobs_done[i] : 0.0;
+        printf("%-2d | %-10s | %-7lld | %-8lld | %-9lld | %-12.2f | %lld\n",
+               task->id, task->name, dag->period[i], dag->job_count[i], dag->jobs_done[i],
+               avg_response, task->max_response);
+    }
+}
+
+// Total and largest per-task utilization C/T over the periodic tasks;
+// returns how many tasks are periodic
+int task_set_utilization(DAG* dag, double* total, double* largest) {
+    int periodic = 0;
+    *total = 0.0;
+    *largest = 0.0;
+    for (int i = 0; i < dag->num_tasks; i++) {
+        if (dag->period[i] <= 0) continue;
+        double u = (double)dag->tasks[i].duration / dag->period[i];
+        *total += u;
+        if (u > *largest) *largest = u;
+        periodic++;
+    }
+    return periodic;
+}
+
+// Sufficient utilization bounds on m cores. One core: Liu & Layland
+// n(2^(1/n) - 1) for RMS and 1 for EDF. Several cores, global scheduling:
+// m/2 (1 - umax) + umax for fixed priorities (Bertogna, Cirinei & Lipari)
+// and m - (m - 1) umax for EDF (Goossens, Funk & Baruah). The multi-core
+// formulas turn negative once umax > 1; such a task misses its deadlines
+// on any number of cores, so nothing is admitted and the bound is 0.
+double rms_utilization_bound(int periodic, int num_cores, double largest) {
+    if (num_cores == 1) {
+        return periodic > 0 ? periodic * (pow(2.0, 1.0 / periodic) - 1.0) : 1.0;
+    }
+    return fmax(0.0, num_cores / 2.0 * (1.0 - largest) + largest);
+}
+
+double edf_utilization_bound(int num_cores, double largest) {
+    return fmax(0.0, num_cores - (num_cores - 1) * largest);
+}
+
+void print_utilization_bounds(DAG* dag, int num_cores) {
+    double total, largest;
+    int periodic = task_set_utilization(dag, &total, &largest);
+    double rms_bound = rms_utilization_bound(periodic, num_cores, largest);
+    double edf_bound = edf_utilization_bound(num_cores, largest);
+    
+    printf("\n===== Utilization Bounds (%d cores, %d periodic tasks) =====\n", num_cores, periodic);
+    printf("Task set utilization: %.3f (largest task %.3f)\n", total, largest);
+    if (largest > 1.0) {
+        printf("Infeasible: a task needs more than its period (C > T) and misses its\n"
+               "deadlines on any number of cores; the bounds do not apply.\n");
+        return;
+    }
+    printf("RMS admits up to:     %.3f  -> %s\n", rms_bound,
+           total <= rms_bound ? "guaranteed" : "not guaranteed");
+    printf("EDF admits up to:     %.3f  -> %s\n", edf_bound,
+           total <= edf_bound ? "guaranteed" : "not guaranteed");
+    printf("Bound gap (EDF - RMS): %.3f (%.1f%% of one core)\n",
+           edf_bound - rms_bound, (edf_bound - rms_bound) * 100.0);
+}
+
+const char* verdict_label(Verdict verdict) {
+    switch (verdict) {
+        case VERDICT_PASS: return "pass";
+        case VERDICT_FAIL: return "fail";
+        default: return "inconclusive";
+    }
+}
+
+double ticks_to_us(SimTime ticks) {
+    return (double)ticks * 1000.0 / ticks_per_ms(time_unit);
+}
+
+// Exact response-time analysis for fixed priorities on one core, using the
+// RMS priorities (equal priorities interfere with each other). Tasks of
+// one RMS priority (one period) are folded into one interference term,
+// and levels are added highest first so each level sees exactly the tasks
+// at or above it. Tasks with period 0 interfere once. Returns the overall
+// verdict and stores each WCRT in ticks, -1 if it exceeds the deadline or
+// horizon.
+Verdict response_time_analysis(DAG* dag, SimTime* wcrt) {
+    int n = dag->num_tasks;
+    int levels = dag->max_priority + 1;
+    
+    // Bucket the tasks by priority (counting sort) and sum each level's work
+    SimTime* level_period = (SimTime*)checked_calloc(levels, sizeof(SimTime), "analysis");
+    SimTime* level_work = (SimTime*)checked_calloc(levels, sizeof(SimTime), "analysis");
+    int* level_start = (int*)checked_calloc(levels + 1, sizeof(int), "analysis");
+    int* by_level = (int*)checked_calloc(n, sizeof(int), "analysis");
+    for (int i = 0; i < n; i++) {
+        level_start[dag->priority[i] + 1]++;
+        level_period[dag->priority[i]] = dag->period[i];
+    }
+    for (int p = 0; p < levels; p++) {
+        level_start[p + 1] += level_start[p];
+    }
+    int* fill = (int*)checked_calloc(levels, sizeof(int), "analysis");
+    memcpy(fill, level_start, levels * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        by_level[fill[dag->priority[i]]++] = i;
     }
+    free(fill);
     
-    // Main simulation loop
-    while (completed_tasks < dag->num_tasks) {
-        // Check for completed tasks
-        for (int i = 0; i < num_cores; i++) {
-            if (!cores[i].is_idle) {
-                Task* task = cores[i].current_task;
-                
-                // Reduce remaining time
-                task->remaining_time--;
-                cores[i].time_slice_remaining--;
-                
-                // Task completed
-                if (task->remaining_time <= 0) {
-                    task->completed = true;
-                    task->core_assigned = -1;
-                    task->finish_time = simulation_time;
-                    completed_tasks++;
-                    
-                    print_execution_trace(simulation_time, i, task, "Completed");
-                    printf("Completed Task %d (%s) on Core %d for %d ms (Period: %d ms, Priority: %d)\n", 
-                           task->id, task->name, i, task->duration, task->period, task->priority);
-                    
-                    cores[i].is_idle = true;
-                    cores[i].current_task = NULL;
-                    cores[i].time_slice_remaining = 0;
-                }
-                // Time slice expired
-                else if (cores[i].time_slice_remaining <= 0) {
-                    print_execution_trace(simulation_time, i, task, "Preempted");
-                    
-                    // Put task back into ready queue
-                    task->core_assigned = -1;
-                    cores[i].is_idle = true;
-                    cores[i].current_task = NULL;
-                }
-            }
+    Verdict verdict = VERDICT_PASS;
+    SimTime horizon = effective_horizon(dag);
+    for (int p = dag->max_priority; p >= MIN_PRIORITY; p--) {
+        for (int k = level_start[p]; k < level_start[p + 1]; k++) {
+            level_work[p] += dag->tasks[by_level[k]].duration;
         }
         
-        // Assign tasks to idle cores
-        for (int i = 0; i < num_cores; i++) {
-            if (cores[i].is_idle) {
-                int task_id = find_highest_priority_ready_task(dag);
-                if (task_id != -1) {
-                    Task* task = &dag->tasks[task_id];
-                    cores[i].current_task = task;
-                    cores[i].is_idle = false;
-                    cores[i].time_slice_remaining = quantum;
-                    
-                    task->core_assigned = i;
-                    if (task->start_time == -1) {
-                        task->start_time = simulation_time;
-                    }
-                    
-                    print_execution_trace(simulation_time, i, task, "Started");
-                    printf("Executing Task %d (%s) on Core %d (Period: %d ms, Priority: %d)\n", 
-                           task->id, task->name, i, task->period, task->priority);
+        for (int k = level_start[p]; k < level_start[p + 1]; k++) {
+            int i = by_level[k];
+            
+            SimTime c = dag->tasks[i].duration;
+            SimTime limit = relative_deadline(dag, i);
+            if (limit <= 0) limit = horizon;
+            
+            SimTime r = c, prev = -1;
+            while (r != prev && r <= limit) {
+                prev = r;
+                SimTime interference = 0;
+                for (int q = dag->max_priority; q >= p; q--) {
+                    if (level_work[q] == 0) continue;
+                    SimTime releases = level_period[q] > 0 ? (prev + level_period[q] - 1) / level_period[q] : 1;
+                    interference += releases * level_work[q];
                 }
+                // The task does not interfere with itself
+                interference -= (dag->period[i] > 0 ? (prev + dag->period[i] - 1) / dag->period[i] : 1) * c;
+                r = c + interference;
             }
-        }
-        
-        // Update simulation time
-        simulation_time++;
-
-        for (int i = 0; i < num_cores; i++) {
-            if (cores[i].is_idle) {
-                cores[i].total_idle_time++;  // Increment idle time counter
+            
+            if (r <= limit) {
+                wcrt[i] = r;
+            } else {
+                wcrt[i] = -1;
+                verdict = VERDICT_FAIL;
             }
         }
-        
-        // Show progress
-        if (simulation_time % 20 == 0) {
-            print_progress_bar(completed_tasks, dag->num_tasks);
+    }
+    
+    free(level_period);
+    free(level_work);
+    free(level_start);
+    free(by_level);
+    return verdict;
+}
+
+// Run every offline test. Utilization tests and RTA treat the tasks as
+// independent periodic tasks on one core; the DAG bound uses precedence
+// and num_cores: in any work-conserving schedule a task finishes by the
+// longest path ending in it plus the remaining work spread over m cores.
+void analyze_schedulability(DAG* dag, int num_cores, SchedAnalysis* analysis) {
+    int n = dag->num_tasks;
+    double largest;
+    int periodic = task_set_utilization(dag, &analysis->utilization, &largest);
+    
+    analysis->liu_layland_bound = rms_utilization_bound(periodic, 1, largest);
+    analysis->liu_layland = analysis->utilization <= analysis->liu_layland_bound
+        ? VERDICT_PASS : VERDICT_INCONCLUSIVE;
+    
+    analysis->hyperbolic_product = 1.0;
+    for (int i = 0; i < n; i++) {
+        if (dag->period[i] > 0) {
+            analysis->hyperbolic_product *= 1.0 + (double)dag->tasks[i].duration / dag->period[i];
         }
-        
-        // Add small delay for visualization
-        delay_ms(10); 
-        
-        // Safety check - prevent infinite loops
-        if (simulation_time > 10000) {
-            printf("\nSimulation exceeded time limit. Possible deadlock or very long tasks.\n");
-            break;
+    }
+    analysis->hyperbolic = analysis->hyperbolic_product <= 2.0 ? VERDICT_PASS : VERDICT_INCONCLUSIVE;
+    if (analysis->utilization > 1.0) {
+        analysis->liu_layland = VERDICT_FAIL;
+        analysis->hyperbolic = VERDICT_FAIL;
+    }
+    
+    SimTime* wcrt = (SimTime*)checked_calloc(n, sizeof(SimTime), "analysis");
+    analysis->rta = response_time_analysis(dag, wcrt);
+    analysis->rta_wcrt_us = (double*)checked_calloc(n, sizeof(double), "analysis");
+    for (int i = 0; i < n; i++) {
+        analysis->rta_wcrt_us[i] = wcrt[i] >= 0 ? ticks_to_us(wcrt[i]) : -1.0;
+    }
+    
+    // Longest path ending in each task, in topological order
+    analysis->volume = 0;
+    analysis->critical_path = 0;
+    for (int i = 0; i < n; i++) {
+        analysis->volume += dag->tasks[i].duration;
+        wcrt[i] = -1;
+    }
+    for (int k = 0; k < dag->topo_count; k++) {
+        int node = dag->topo_order[k];
+        SimTime longest = 0;
+        for (int e = dag->pred_offsets[node]; e < dag->pred_offsets[node + 1]; e++) {
+            if (wcrt[dag->pred_sources[e]] > longest) longest = wcrt[dag->pred_sources[e]];
         }
+        wcrt[node] = longest + dag->tasks[node].duration;
+        if (wcrt[node] > analysis->critical_path) analysis->critical_path = wcrt[node];
     }
     
-    printf("\nSimulation completed in %d time units\n", simulation_time);
+    SimTime horizon = effective_horizon(dag);
+    analysis->dag_wcrt_us = (double*)checked_calloc(n, sizeof(double), "analysis");
+    for (int i = 0; i < n; i++) {
+        double bound = wcrt[i] + (double)(analysis->volume - wcrt[i]) / num_cores;
+        analysis->dag_wcrt_us[i] = (wcrt[i] >= 0 && bound <= horizon) ? ticks_to_us((SimTime)ceil(bound)) : -1.0;
+    }
+    analysis->dag_bound = analysis->critical_path + (double)(analysis->volume - analysis->critical_path) / num_cores;
     
-    // Print results
-    printf("\n===== Execution Results with Rate Monotonic Scheduling =====\n");
-    printf("ID | Name       | Duration | Period  | Priority | Start | Finish | Turnaround\n");
-    printf("-------------------------------------------------------------------\n");
+    // Makespan is at least the critical path and the volume per core
+    double lower = (double)analysis->volume / num_cores;
+    if (analysis->critical_path > lower) lower = analysis->critical_path;
+    if (dag->has_cycles || lower > horizon) {
+        analysis->dag = VERDICT_FAIL;
+    } else if (analysis->dag_bound <= horizon) {
+        analysis->dag = VERDICT_PASS;
+    } else {
+        analysis->dag = VERDICT_INCONCLUSIVE;
+    }
+    
+    free(wcrt);
+}
+
+void free_schedulability_analysis(SchedAnalysis* analysis) {
+    free(analysis->rta_wcrt_us);
+    free(analysis->dag_wcrt_us);
+    analysis->rta_wcrt_us = NULL;
+    analysis->dag_wcrt_us = NULL;
+}
+
+void print_schedulability_analysis(DAG* dag, int num_cores, SchedAnalysis* analysis) {
+    printf("\n===== Schedulability Analysis (%d tasks, %d cores) =====\n", dag->num_tasks, num_cores);
+    printf("Liu-Layland bound (1 core): U = %.3f <= %.3f -> %s\n",
+           analysis->utilization, analysis->liu_layland_bound, verdict_label(analysis->liu_layland));
+    printf("Hyperbolic bound (1 core):  prod(U+1) = %.3f <= 2 -> %s\n",
+           analysis->hyperbolic_product, verdict_label(analysis->hyperbolic));
+    printf("Response-time analysis (1 core, RMS priorities): %s\n", verdict_label(analysis->rta));
+    printf("DAG bound (%d cores): %lld + (%lld - %lld) / %d = %.1f %s, horizon %lld -> %s\n",
+           num_cores, analysis->critical_path, analysis->volume, analysis->critical_path, num_cores,
+           analysis->dag_bound, time_unit_label(time_unit), effective_horizon(dag),
+           verdict_label(analysis->dag));
     
-    int total_turnaround = 0;
+    // Per-task bounds only for DAGs small enough to read
+    if (dag->num_tasks > 64) return;
+    printf("\nID | Priority | Deadline (us) | RTA WCRT (us) | DAG WCRT (us)\n");
+    printf("------------------------------------------------------------\n");
     for (int i = 0; i < dag->num_tasks; i++) {
-        Task* task = &dag->tasks[i];
-        int turnaround = task->finish_time - task->start_time;
-        total_turnaround += turnaround;
-        
-        printf("%-2d | %-10s | %-8d | %-7d | %-8d | %-5d | %-6d | %-10d\n",
-               task->id, task->name, task->duration, task->period, task->priority,
-               task->start_time, task->finish_time, turnaround);
+        printf("%-2d | %-8d | %-13.0f | ", i, dag->priority[i], ticks_to_us(relative_deadline(dag, i)));
+        if (analysis->rta_wcrt_us[i] >= 0) printf("%-13.0f | ", analysis->rta_wcrt_us[i]);
+        else printf("%-13s | ", "miss");
+        if (analysis->dag_wcrt_us[i] >= 0) printf("%.0f\n", analysis->dag_wcrt_us[i]);
+        else printf("beyond horizon\n");
     }
+}
+
+// One key=value line with every verdict, for batch sweeps
+void print_analysis_summary(SchedAnalysis* analysis) {
+    printf("analysis utilization=%.3f liu_layland=%s hyperbolic=%s rta=%s "
+           "critical_path=%lld volume=%lld dag_bound=%.1f dag=%s\n",
+           analysis->utilization, verdict_label(analysis->liu_layland),
+           verdict_label(analysis->hyperbolic), verdict_label(analysis->rta),
+           analysis->critical_path, analysis->volume, analysis->dag_bound,
+           verdict_label(analysis->dag));
+}
+
+// Dead time each core spent on context switches, migrations and cache
+// refills; utilization above counts it as busy time
+void print_scheduling_overhead(int num_cores) {
+    printf("\n===== Scheduling Overhead (switch %lld, migration %lld, refill %lld %s) =====\n",
+           context_switch_cost, migration_cost, cache_refill_cost, time_unit_label(time_unit));
+    printf("Core | Switches | Migrations | Refills | Overhead | %% of Busy\n");
+    printf("------------------------------------------------------------\n");
     
-    printf("\nAverage Turnaround Time: %.2f\n", (float)total_turnaround / dag->num_tasks);
+    SimTime total_overhead = 0;
+    SimTime total_busy = 0;
+    for (int i = 0; i < num_cores; i++) {
+        SimTime busy_time = simulation_time - cores[i].total_idle_time;
+        total_overhead += cores[i].overhead_time;
+        total_busy += busy_time;
+        printf("%-4d | %-8d | %-10d | %-7d | %-8lld | %.2f%%\n",
+               i, cores[i].context_switches, cores[i].migrations, cores[i].cache_refills,
+               cores[i].overhead_time, busy_time > 0 ? (double)cores[i].overhead_time / busy_time * 100.0 : 0.0);
+    }
+    printf("Total overhead: %lld %s (%.2f%% of busy time)\n", total_overhead, time_unit_label(time_unit),
+           total_busy > 0 ? (double)total_overhead / total_busy * 100.0 : 0.0);
+}
 
-    printf("\n===== Core Utilization Statistics =====\n");
-    printf("Core | Busy Time | Idle Time | Utilization %%\n");
-    printf("----------------------------------------\n");
+// Costed inputs a core received locally or from another core, and the time
+// it waited for transfers
+void print_data_transfers(DAG* dag, int num_cores) {
+    SimTime total_cost = 0;
+    for (int e = 0; e < dag->num_edges; e++) {
+        total_cost += dag->pred_costs[e];
+    }
+    printf("\n===== Data Transfers (dispatch %s, %lld %s of edge cost in the DAG) =====\n",
+           dispatch_rule_name(dispatch_rule), total_cost, time_unit_label(time_unit));
+    printf("Core | Remote Inputs | Local Inputs | Transfer Wait\n");
+    printf("--------------------------------------------------\n");
+    
+    int remote = 0, local = 0;
+    SimTime wait = 0;
+    for (int i = 0; i < num_cores; i++) {
+        printf("%-4d | %-13d | %-12d | %lld\n",
+               i, cores[i].remote_inputs, cores[i].local_inputs, cores[i].transfer_time);
+        remote += cores[i].remote_inputs;
+        local += cores[i].local_inputs;
+        wait += cores[i].transfer_time;
+    }
+    printf("Total: %d remote, %d local inputs, %lld %s waiting for transfers\n",
+           remote, local, wait, time_unit_label(time_unit));
+}
 
-    float total_utilization = 0.0;
+// Preempted tasks that resumed on another core, per core and per task
+void print_migrations(DAG* dag, int num_cores) {
+    int total = 0, within_cluster = 0;
     for (int i = 0; i < num_cores; i++) {
-        int busy_time = simulation_time - cores[i].total_idle_time;
-        float utilization = (float)busy_time / simulation_time * 100.0;
-        total_utilization += utilization;
-        
-        printf("%-4d | %-9d | %-9d | %.2f%%\n",
-               i, busy_time, cores[i].total_idle_time, utilization);
+        total += cores[i].migrations;
+        within_cluster += cores[i].cluster_migrations;
+    }
+    if (total == 0 && dispatch_rule != DISPATCH_AFFINITY) return;
+    
+    printf("\n===== Migrations (dispatch %s, cluster size %d", dispatch_rule_name(dispatch_rule), cluster_size);
+    if (dispatch_rule == DISPATCH_AFFINITY) {
+        printf(", affinity wait %lld %s", affinity_wait, time_unit_label(time_unit));
+    }
+    printf(") =====\n");
+    printf("Total: %d, within a cache cluster: %d\n", total, within_cluster);
+    printf("Per core (resumed here):");
+    for (int i = 0; i < num_cores; i++) {
+        printf(" %d:%d", i, cores[i].migrations);
+    }
+    printf("\nPer task:");
+    int listed = 0;
+    for (int i = 0; i < dag->num_tasks; i++) {
+        if (dag->tasks[i].migrations > 0) {
+            printf(" %s:%d", dag->tasks[i].name, dag->tasks[i].migrations);
+            listed++;
+        }
+    }
+    printf(listed > 0 ? "\n" : " none\n");
+}
+
+// Name the tasks whose (last) job finished on a core slower than nominal
+void print_slow_core_tasks(DAG* dag, int num_cores) {
+    bool any_slow = false;
+    for (int i = 0; i < num_cores; i++) {
+        if (cores[i].speed < SPEED_NOMINAL) any_slow = true;
+    }
+    if (!any_slow) return;
+    
+    int count = 0;
+    printf("Tasks finished on slow cores:");
+    for (int i = 0; i < dag->num_tasks; i++) {
+        int core_id = dag->tasks[i].finish_core;
+        if (core_id >= 0 && cores[core_id].speed < SPEED_NOMINAL) {
+            printf(" %s (core %d, %d%%)", dag->tasks[i].name, core_id, cores[core_id].speed);
+            count++;
+        }
     }
+    printf(count > 0 ? "\n" : " none\n");
+}
 
-    printf("\nAverage Core Utilization: %.2f%%\n", total_utilization / num_cores);
+// Read a comma-separated list of core speeds in percent into the global
+// configuration; "-" restores nominal speed on every core
+bool parse_core_speeds(const char* list) {
+    if (strcmp(list, "-") == 0) {
+        free(core_speed_config);
+        core_speed_config = NULL;
+        num_core_speeds = 0;
+        return true;
+    }
     
-    // Clean up
-    free(cores);
-    cores = NULL;
+    int count = 1;
+    for (const char* c = list; *c; c++) {
+        if (*c == ',') count++;
+    }
+    int* speeds = (int*)checked_calloc(count, sizeof(int), "core speeds");
+    const char* cursor = list;
+    for (int i = 0; i < count; i++) {
+        char* end;
+        long speed = strtol(cursor, &end, 10);
+        if (end == cursor || speed < 1 || speed > MAX_SPEED || (*end != ',' && *end != '\0')) {
+            free(speeds);
+            return false;
+        }
+        speeds[i] = (int)speed;
+        cursor = end + 1;
+    }
+    
+    free(core_speed_config);
+    core_speed_config = speeds;
+    num_core_speeds = count;
+    return true;
+}
+
+// One machine-readable line per run for batch sweeps
+void print_simulation_summary(DAG* dag, int num_cores) {
+    SimTime total_busy = 0;
+    SimTime total_overhead = 0;
+    SimTime transfer_wait = 0;
+    long long switches = 0, migrations = 0;
+    for (int i = 0; i < num_cores; i++) {
+        total_busy += simulation_time - cores[i].total_idle_time;
+        total_overhead += cores[i].overhead_time;
+        transfer_wait += cores[i].transfer_time;
+        switches += cores[i].context_switches;
+        migrations += cores[i].migrations;
+    }
+    
+    double total_u, largest_u;
+    int periodic = task_set_utilization(dag, &total_u, &largest_u);
+    DeadlineTotals totals;
+    sum_deadline_metrics(dag, &totals);
+    
+    printf("engine=%s policy=%s dispatch=%s unit=%s load_ms=%.3f tasks=%d completed=%d jobs=%lld completed_jobs=%lld "
+           "cores=%d quantum=%lld makespan=%lld "
+           "avg_turnaround=%.2f avg_utilization=%.2f deadline_misses=%lld deadline_jobs=%lld "
+           "max_lateness=%lld total_tardiness=%lld "
+           "context_switches=%lld migrations=%lld overhead=%lld transfer_wait=%lld "
+           "task_utilization=%.3f max_task_utilization=%.3f rms_bound=%.3f edf_bound=%.3f\n",
+           engine_name(sim_engine), policy_name(sched_policy), dispatch_rule_name(dispatch_rule),
+           time_unit_label(time_unit), dag_load_ms,
+           dag->num_tasks, completed_tasks, total_jobs, completed_jobs, num_cores, quantum, simulation_time,
+           average_turnaround(dag),
+           simulation_time > 0 ? (double)total_busy / ((double)simulation_time * num_cores) * 100.0 : 0.0,
+           totals.misses, totals.deadline_jobs,
+           totals.deadline_jobs > 0 ? totals.max_lateness : 0, totals.total_tardiness,
+           switches, migrations, total_overhead, transfer_wait,
+           total_u, largest_u, rms_utilization_bound(periodic, num_cores, largest_u),
+           edf_utilization_bound(num_cores, largest_u));
+    free_deadline_totals(&totals);
 }
 
 void run_performance_comparison(int num_cores) {
@@ -611,17 +4179,216 @@ void run_performance_comparison(int num_cores) {
         current_dag = create_sample_dag();
     }
     
-    printf("\n----- Performance Comparison with Rate Monotonic Scheduling -----\n");
+    printf("\n----- Performance Comparison with %s -----\n", policy_title(sched_policy));
     printf("DAG: %s\n", "Sample DAG");
     printf("Number of Tasks: %d\n", current_dag->num_tasks);
     printf("Number of Cores: %d\n", num_cores);
     
-    // Run hybrid scheduler with RMS
+    // Analytical pre-check before simulating
+    SchedAnalysis analysis;
+    analyze_schedulability(current_dag, num_cores, &analysis);
+    print_schedulability_analysis(current_dag, num_cores, &analysis);
+    free_schedulability_analysis(&analysis);
+    
+    // Run hybrid scheduler with the selected policy
     simulate_hybrid_scheduler(current_dag, num_cores);
     
+    compare_policies(current_dag, num_cores);
+    
     printf("\nPerformance comparison completed.\n");
 }
 
+// Run the DAG once under every policy without output and print the
+// makespans side by side. The results of the selected policy are restored
+// afterwards so they can still be exported; the timeline trace and event
+// log keep the selected policy's run, which was recorded before the
+// comparison.
+void compare_policies(DAG* dag, int num_cores) {
+    SchedPolicy policies[] = { POLICY_RMS, POLICY_CRITICAL_PATH, POLICY_HYBRID, POLICY_EDF };
+    int num_policies = sizeof(policies) / sizeof(policies[0]);
+    SimTime makespan[4];
+    double avg_turnaround[4];
+    int completed[4];
+    
+    SchedPolicy selected = sched_policy;
+    char saved_job_csv[sizeof(job_csv_path)];
+    strcpy(saved_job_csv, job_csv_path);
+    job_csv_path[0] = '\0';
+    char saved_trace[sizeof(trace_path)];
+    strcpy(saved_trace, trace_path);
+    trace_path[0] = '\0';
+    char saved_event_log[sizeof(event_log_path)];
+    strcpy(saved_event_log, event_log_path);
+    event_log_path[0] = '\0';
+    bool saved_headless = headless_mode;
+    bool saved_debug = debug_mode;
+    OutputFormat saved_format = output_format;
+    headless_mode = true;
+    debug_mode = false;
+    output_format = OUTPUT_NONE;
+    
+    for (int p = 0; p < num_policies; p++) {
+        sched_policy = policies[p];
+        simulate_hybrid_scheduler(dag, num_cores);
+        
+        makespan[p] = simulation_time;
+        avg_turnaround[p] = average_turnaround(dag);
+        completed[p] = completed_tasks;
+    }
+    
+    sched_policy = selected;
+    strcpy(job_csv_path, saved_job_csv);
+    simulate_hybrid_scheduler(dag, num_cores);
+    strcpy(trace_path, saved_trace);
+    strcpy(event_log_path, saved_event_log);
+    headless_mode = saved_headless;
+    debug_mode = saved_debug;
+    output_format = saved_format;
+    
+    printf("\n===== Policy Comparison (%d cores, %s engine) =====\n", num_cores, engine_name(sim_engine));
+    printf("Policy | Makespan | Avg Turnaround | Completed\n");
+    printf("---------------------------------------------\n");
+    for (int p = 0; p < num_policies; p++) {
+        printf("%-6s | %-8lld | %-14.2f | %d/%d%s\n",
+               policy_name(policies[p]), makespan[p], avg_turnaround[p],
+               completed[p], dag->num_tasks, policies[p] == selected ? "  (selected)" : "");
+    }
+    if (selected == POLICY_HYBRID || cp_weight != DEFAULT_CP_WEIGHT) {
+        printf("Hybrid weight: %d%% critical path, %d%% RMS\n", cp_weight, 100 - cp_weight);
+    }
+}
+
+// Schedule of one run as compared by compare_engines
+typedef struct {
+    SimTime* start;
+    SimTime* finish;
+    int* core;
+    int* migrations;
+    SimTime makespan;
+    long long completed_jobs;
+    SimTime overhead;
+    SimTime transfer;
+} EngineRun;
+
+void record_engine_run(DAG* dag, int num_cores, EngineRun* run) {
+    run->start = (SimTime*)checked_calloc(dag->num_tasks, sizeof(SimTime), "engine comparison");
+    run->finish = (SimTime*)checked_calloc(dag->num_tasks, sizeof(SimTime), "engine comparison");
+    run->core = (int*)checked_calloc(dag->num_tasks, sizeof(int), "engine comparison");
+    run->migrations = (int*)checked_calloc(dag->num_tasks, sizeof(int), "engine comparison");
+    for (int i = 0; i < dag->num_tasks; i++) {
+        run->start[i] = dag->tasks[i].start_time;
+        run->finish[i] = dag->tasks[i].finish_time;
+        run->core[i] = dag->tasks[i].finish_core;
+        run->migrations[i] = dag->tasks[i].migrations;
+    }
+    run->makespan = simulation_time;
+    run->completed_jobs = completed_jobs;
+    run->overhead = 0;
+    run->transfer = 0;
+    for (int i = 0; i < num_cores; i++) {
+        run->overhead += cores[i].overhead_time;
+        run->transfer += cores[i].transfer_time;
+    }
+}
+
+void free_engine_run(EngineRun* run) {
+    free(run->start);
+    free(run->finish);
+    free(run->core);
+    free(run->migrations);
+}
+
+// Run the DAG on the tick and the event engine with the current settings
+// and check that both produce the same schedule: per-task start, finish,
+// core and migrations, and the totals. Prints one engines=... line and
+// returns whether they agree.
+bool compare_engines(DAG* dag, int num_cores) {
+    SimEngine saved_engine = sim_engine;
+    char saved_job_csv[sizeof(job_csv_path)];
+    char saved_trace[sizeof(trace_path)];
+    strcpy(saved_job_csv, job_csv_path);
+    strcpy(saved_trace, trace_path);
+    job_csv_path[0] = '\0';
+    trace_path[0] = '\0';
+    bool saved_headless = headless_mode;
+    bool saved_debug = debug_mode;
+    OutputFormat saved_format = output_format;
+    headless_mode = true;
+    debug_mode = false;
+    output_format = OUTPUT_NONE;
+    
+    EngineRun runs[2];
+    SimEngine engines[2] = { ENGINE_TICK, ENGINE_EVENT };
+    for (int r = 0; r < 2; r++) {
+        sim_engine = engines[r];
+        simulate_hybrid_scheduler(dag, num_cores);
+        record_engine_run(dag, num_cores, &runs[r]);
+    }
+    
+    sim_engine = saved_engine;
+    strcpy(job_csv_path, saved_job_csv);
+    strcpy(trace_path, saved_trace);
+    headless_mode = saved_headless;
+    debug_mode = saved_debug;
+    output_format = saved_format;
+    
+    int first_diff = -1;
+    for (int i = 0; i < dag->num_tasks && first_diff == -1; i++) {
+        if (runs[0].start[i] != runs[1].start[i] || runs[0].finish[i] != runs[1].finish[i] ||
+            runs[0].core[i] != runs[1].core[i] || runs[0].migrations[i] != runs[1].migrations[i]) {
+            first_diff = i;
+        }
+    }
+    bool same = first_diff == -1 && runs[0].makespan == runs[1].makespan &&
+                runs[0].completed_jobs == runs[1].completed_jobs &&
+                runs[0].overhead == runs[1].overhead && runs[0].transfer == runs[1].transfer;
+    
+    if (same) {
+        printf("engines=identical makespan=%lld\n", runs[0].makespan);
+    } else if (first_diff != -1) {
+        printf("engines=differ task=%d tick_start=%lld tick_finish=%lld tick_core=%d "
+               "event_start=%lld event_finish=%lld event_core=%d\n", first_diff,
+               runs[0].start[first_diff], runs[0].finish[first_diff], runs[0].core[first_diff],
+               runs[1].start[first_diff], runs[1].finish[first_diff], runs[1].core[first_diff]);
+    } else {
+        printf("engines=differ tick_makespan=%lld event_makespan=%lld tick_overhead=%lld "
+               "event_overhead=%lld tick_transfer=%lld event_transfer=%lld\n",
+               runs[0].makespan, runs[1].makespan, runs[0].overhead, runs[1].overhead,
+               runs[0].transfer, runs[1].transfer);
+    }
+    free_engine_run(&runs[0]);
+    free_engine_run(&runs[1]);
+    return same;
+}
+
+void write_task_results_csv(FILE* file, DAG* dag) {
+    // Write header; periodic runs report the mean job response time
+    fprintf(file, "Task ID,Task Name,Duration,Period,Priority,Start Time,Finish Time,%s,"
+                  "Deadline,Deadline Jobs,Deadline Misses,Max Lateness,Total Tardiness,Core,Migrations\n",
+            periodic_mode ? "Avg Response Time" : "Turnaround Time");
+    
+    // Write data; deadline fields stay empty for tasks without a deadline
+    for (int i = 0; i < dag->num_tasks; i++) {
+        Task* task = &dag->tasks[i];
+        
+        fprintf(file, "%d,%s,%lld,%lld,%d,%lld,%lld,",
+                task->id, task->name, task->duration, dag->period[i], dag->priority[i],
+                task->start_time, task->finish_time);
+        if (periodic_mode) fprintf(file, "%.2f,", task_turnaround(dag, i));
+        else fprintf(file, "%lld,", task->finish_time - task->start_time);
+        if (relative_deadline(dag, i) <= 0) {
+            fprintf(file, ",,,,,");
+        } else if (task->deadline_jobs == 0) {
+            fprintf(file, "%lld,0,0,,0,", relative_deadline(dag, i));
+        } else {
+            fprintf(file, "%lld,%lld,%lld,%lld,%lld,", relative_deadline(dag, i), task->deadline_jobs,
+                    task->deadline_misses, task->max_lateness, task->total_tardiness);
+        }
+        if (task->finish_core >= 0) fprintf(file, "%d,%d\n", task->finish_core, task->migrations);
+        else fprintf(file, ",%d\n", task->migrations);
+    }
+}
+
 void export_results_to_csv(DAG* dag, char* scheduler_name, int num_cores) {
     if (!dag) {
         printf("No DAG results available to export.\n");
@@ -637,18 +4404,7 @@ void export_results_to_csv(DAG* dag, char* scheduler_name, int num_cores) {
         return;
     }
     
-    // Write header
-    fprintf(file, "Task ID,Task Name,Duration,Period,Priority,Start Time,Finish Time,Turnaround Time\n");
-    
-    // Write data
-    for (int i = 0; i < dag->num_tasks; i++) {
-        Task* task = &dag->tasks[i];
-        int turnaround = task->finish_time - task->start_time;
-        
-        fprintf(file, "%d,%s,%d,%d,%d,%d,%d,%d\n",
-                task->id, task->name, task->duration, task->period, task->priority,
-                task->start_time, task->finish_time, turnaround);
-    }
+    write_task_results_csv(file, dag);
     
     fclose(file);
     printf("Results exported to %s\n", filename);
@@ -662,57 +4418,469 @@ void export_results_to_csv(DAG* dag, char* scheduler_name, int num_cores) {
     }
     
     // Write header
-    fprintf(util_file, "Core ID,Busy Time,Idle Time,Utilization\n");
+    fprintf(util_file, "Core ID,Busy Time,Idle Time,Utilization,Speed,Work Done,Tasks Finished,"
+                       "Context Switches,Migrations,Cache Refills,Overhead Time,"
+                       "Remote Inputs,Local Inputs,Transfer Wait\n");
     
     // Write data
     for (int i = 0; i < num_cores; i++) {
-        int busy_time = simulation_time - cores[i].total_idle_time;
-        float utilization = (float)busy_time / simulation_time * 100.0;
+        SimTime busy_time = simulation_time - cores[i].total_idle_time;
+        float utilization = (double)busy_time / simulation_time * 100.0;
         
-        fprintf(util_file, "%d,%d,%d,%.2f\n",
-                i, busy_time, cores[i].total_idle_time, utilization);
+        fprintf(util_file, "%d,%lld,%lld,%.2f,%d,%lld,%d,%d,%d,%d,%lld,%d,%d,%lld\n",
+                i, busy_time, cores[i].total_idle_time, utilization, cores[i].speed,
+                cores[i].work_done / SPEED_NOMINAL, cores[i].tasks_finished,
+                cores[i].context_switches, cores[i].migrations, cores[i].cache_refills,
+                cores[i].overhead_time, cores[i].remote_inputs, cores[i].local_inputs,
+                cores[i].transfer_time);
     }
     
     fclose(util_file);
     printf("Core utilization metrics exported to %s\n", util_filename);
+    
+    char deadline_filename[100];
+    sprintf(deadline_filename, "deadline_metrics_%s_%d_cores.csv", scheduler_name, num_cores);
+    
+    FILE* deadline_file = fopen(deadline_filename, "w");
+    if (!deadline_file) {
+        printf("Failed to create deadline metrics CSV file.\n");
+        return;
+    }
+    
+    DeadlineTotals totals;
+    sum_deadline_metrics(dag, &totals);
+    
+    // Per-priority miss ratios, then the aggregate as priority "all"
+    fprintf(deadline_file, "Priority,Jobs,Misses,Miss Ratio,Max Lateness,Total Tardiness\n");
+    for (int p = totals.max_priority; p >= MIN_PRIORITY; p--) {
+        if (totals.jobs_by_priority[p] == 0) continue;
+        fprintf(deadline_file, "%d,%lld,%lld,%.4f,,\n", p, totals.jobs_by_priority[p],
+                totals.misses_by_priority[p],
+                (double)totals.misses_by_priority[p] / totals.jobs_by_priority[p]);
+    }
+    if (totals.deadline_jobs > 0) {
+        fprintf(deadline_file, "all,%lld,%lld,%.4f,%lld,%lld\n", totals.deadline_jobs, totals.misses,
+                (double)totals.misses / totals.deadline_jobs, totals.max_lateness, totals.total_tardiness);
+    }
+    free_deadline_totals(&totals);
+    
+    fclose(deadline_file);
+    printf("Deadline metrics exported to %s\n", deadline_filename);
 }
 
 void free_dag(DAG* dag) {
     if (!dag) return;
     
-    // Free adjacency matrix
-    if (dag->adjacency_matrix) {
-        for (int i = 0; i < dag->num_tasks; i++) {
-            free(dag->adjacency_matrix[i]);
-        }
-        free(dag->adjacency_matrix);
-    }
+    // Free edge storage
+    free(dag->edge_from);
+    free(dag->edge_to);
+    free(dag->edge_cost);
+    free_dag_array(dag, dag->succ_offsets);
+    free_dag_array(dag, dag->succ_targets);
+    free_dag_array(dag, dag->pred_offsets);
+    free_dag_array(dag, dag->pred_sources);
+    free_dag_array(dag, dag->succ_costs);
+    free_dag_array(dag, dag->pred_costs);
+    free_dag_array(dag, dag->pred_edge_index);
+    free(dag->edge_finish);
+    free(dag->edge_core);
+    free_dag_array(dag, dag->topo_order);
+    free_dag_array(dag, dag->level);
     
     // Free tasks
     if (dag->tasks) {
         free(dag->tasks);
     }
+    free(dag->remaining_time);
+    free(dag->period);
+    free(dag->priority);
+    free(dag->upward_rank);
+    free(dag->dispatch_key);
+    free(dag->release_time);
+    free(dag->abs_deadline);
+    free(dag->job_count);
+    free(dag->jobs_done);
+    free(dag->job_start);
+    free(dag->pending_deps);
+    free(dag->core_assigned);
+    free(dag->completed);
+    if (dag->mapping) {
+        munmap(dag->mapping, dag->mapping_size);
+    }
     
     free(dag);
 }
 
-int main() {
+// Convert a time value between resolutions given in ticks per millisecond.
+// Coarsening rounds up so that nothing shrinks to zero.
+SimTime rescale_time(SimTime value, SimTime from, SimTime to) {
+    if (to >= from) {
+        return value * (to / from);
+    }
+    return (value + (from / to) - 1) / (from / to);
+}
+
+// Switch the clock resolution, rescaling the current DAG and the time
+// settings so they keep describing the same wall-clock amounts
+void set_time_unit(TimeUnit unit) {
+    SimTime from = ticks_per_ms(time_unit);
+    SimTime to = ticks_per_ms(unit);
+    if (from == to) return;
+    
+    if (current_dag) {
+        for (int i = 0; i < current_dag->num_tasks; i++) {
+            current_dag->tasks[i].duration = rescale_time(current_dag->tasks[i].duration, from, to);
+            current_dag->period[i] = rescale_time(current_dag->period[i], from, to);
+            current_dag->tasks[i].deadline = rescale_time(current_dag->tasks[i].deadline, from, to);
+        }
+        if (current_dag->succ_costs) {
+            for (int e = 0; e < current_dag->num_edges; e++) {
+                current_dag->succ_costs[e] = rescale_time(current_dag->succ_costs[e], from, to);
+                current_dag->pred_costs[e] = rescale_time(current_dag->pred_costs[e], from, to);
+            }
+        }
+    }
+    quantum = rescale_time(quantum, from, to);
+    context_switch_cost = rescale_time(context_switch_cost, from, to);
+    migration_cost = rescale_time(migration_cost, from, to);
+    cache_refill_cost = rescale_time(cache_refill_cost, from, to);
+    affinity_wait = rescale_time(affinity_wait, from, to);
+    simulation_horizon = rescale_time(simulation_horizon, from, to);
+    
+    time_unit = unit;
+    if (current_dag) {
+        reset_dag_execution(current_dag);
+        apply_rate_monotonic_scheduling(current_dag);
+    }
+}
+
+void print_usage(const char* program) {
+    printf("Usage: %s [--headless] [options]\n", program);
+    printf("Without arguments the interactive menu is started. Any option runs a\n");
+    printf("single headless simulation (of the sample DAG unless --dag or --generate\n");
+    printf("is given) with no per-event output. Exit status: 0 when every task\n");
+    printf("completed, 1 for invalid arguments or input, 2 when the horizon was\n");
+    printf("reached first (or --precheck failed).\n\n");
+    printf("  --headless              batch mode (implied by any other option)\n");
+    printf("  --dag FILE              load the DAG from a task/edge list or Graphviz DOT\n");
+    printf("                          file, or a binary DAG file (mapped), instead of\n");
+    printf("                          using the sample DAG\n");
+    printf("  --generate N            simulate a random layered DAG of N tasks instead\n");
+    printf("  --max-deps D            generated tasks depend on 1..D earlier tasks\n");
+    printf("                          (default %d)\n", DEFAULT_MAX_DEPS);
+    printf("  --seed S                generator seed; the same seed gives the same DAG\n");
+    printf("                          (default 1)\n");
+    printf("  --convert OUT           write the --dag file to OUT in the binary format,\n");
+    printf("                          then report text and binary load times\n");
+    printf("  --cores N               number of cores (default 4)\n");
+    printf("  --quantum Q             time slice in time units (default %d ms)\n", DEFAULT_QUANTUM);
+    printf("  --engine tick|event|threaded\n");
+    printf("                          simulation engine, or real execution on one\n");
+    printf("                          thread per core (default event)\n");
+    printf("  --policy rms|cp|hybrid|edf\n");
+    printf("                          dispatch order: rate monotonic, critical path\n");
+    printf("                          (upward rank), a blend of both, or earliest\n");
+    printf("                          deadline first (default rms)\n");
+    printf("  --speeds S1,S2,...      core speeds in percent of nominal, one per core\n");
+    printf("                          (missing cores run at 100)\n");
+    printf("  --dispatch eft|first-idle|affinity\n");
+    printf("                          place ready tasks on the core that finishes them\n");
+    printf("                          first, on the first idle core, or return preempted\n");
+    printf("                          tasks to their cache cluster (default eft)\n");
+    printf("  --edge-costs            successors on another core than a predecessor\n");
+    printf("                          wait for the dependency's transfer cost\n");
+    printf("  --cluster-size N        consecutive cores sharing a cache (default 1)\n");
+    printf("  --affinity-wait T       affinity: longest wait for the cluster (default 0)\n");
+    printf("  --switch-cost C         dead time per context switch (default 0)\n");
+    printf("  --migration-cost C      extra dead time when a preempted task resumes\n");
+    printf("                          on another core (default 0)\n");
+    printf("  --refill-cost C         extra dead time when it resumes on its own core\n");
+    printf("                          after another task ran there (default 0)\n");
+    printf("  --cp-weight W           hybrid policy: critical path share in percent\n");
+    printf("                          (default %d)\n", DEFAULT_CP_WEIGHT);
+    printf("  --compare-policies      also run every policy and print their makespans\n");
+    printf("  --compare-engines       also run the tick and event engines and check that\n");
+    printf("                          their schedules are identical (exit 3 if not)\n");
+    printf("  --analyze               only run the offline schedulability analysis\n");
+    printf("  --precheck              analyze first and skip the simulation (exit 2)\n");
+    printf("                          when the DAG cannot finish within the horizon\n");
+    printf("  --unit ms|us|ns         clock resolution (default ms)\n");
+    printf("  --horizon T             stop after T time units (default %d ms, or the\n", DEFAULT_HORIZON_MS);
+    printf("                          hyperperiod with --periodic)\n");
+    printf("  --periodic              release a job of every task each period\n");
+    printf("  --jobs-csv FILE         with --periodic, stream per-job results to FILE\n");
+    printf("                          (- for stdout)\n");
+    printf("  --trace FILE            record per-core execution slices and write them to\n");
+    printf("                          FILE as Chrome Trace JSON (Perfetto, chrome://tracing)\n");
+    printf("  --event-log FILE        threaded engine: stream binary start, finish and steal\n");
+    printf("                          records through per-core lock-free rings to FILE\n");
+    printf("  --decode-log FILE       print an event log as an execution trace for the\n");
+    printf("                          sample DAG or --dag FILE, then exit\n");
+    printf("  --format table|summary|csv\n");
+    printf("                          result tables, one key=value line, or per-task CSV\n");
+    printf("                          (default summary)\n");
+    printf("  --help                  show this message\n");
+}
+
+// Headless batch run configured from the command line. Returns the process
+// exit status: 0 when every task completed, 1 for bad arguments and 2 when
+// the horizon was reached first.
+int run_batch(int argc, char* argv[]) {
+    int num_cores = 4;
+    SimTime quantum_arg = 0;
+    SimTime horizon_arg = 0;
+    bool compare = false;
+    bool check_engines = false;
+    bool analyze_only = false;
+    bool precheck = false;
+    const char* dag_file = NULL;
+    const char* convert_path = NULL;
+    const char* decode_path = NULL;
+    int generate_tasks = 0;
+    int max_deps = DEFAULT_MAX_DEPS;
+    unsigned int seed = 1;
+    
+    headless_mode = true;
+    output_format = OUTPUT_SUMMARY;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        
+        if (strcmp(arg, "--headless") == 0) {
+            continue;
+        } else if (strcmp(arg, "--compare-policies") == 0) {
+            compare = true;
+            continue;
+        } else if (strcmp(arg, "--compare-engines") == 0) {
+            check_engines = true;
+            continue;
+        } else if (strcmp(arg, "--analyze") == 0) {
+            analyze_only = true;
+            continue;
+        } else if (strcmp(arg, "--precheck") == 0) {
+            precheck = true;
+            continue;
+        } else if (strcmp(arg, "--periodic") == 0) {
+            periodic_mode = true;
+            continue;
+        } else if (strcmp(arg, "--edge-costs") == 0) {
+            edge_costs_enabled = true;
+            continue;
+        } else if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        } else if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 1;
+        }
+        
+        if (strcmp(arg, "--cores") == 0) {
+            num_cores = atoi(value);
+        } else if (strcmp(arg, "--quantum") == 0) {
+            quantum_arg = atoll(value);
+        } else if (strcmp(arg, "--horizon") == 0) {
+            horizon_arg = atoll(value);
+        } else if (strcmp(arg, "--engine") == 0 && strcmp(value, "tick") == 0) {
+            sim_engine = ENGINE_TICK;
+        } else if (strcmp(arg, "--engine") == 0 && strcmp(value, "event") == 0) {
+            sim_engine = ENGINE_EVENT;
+        } else if (strcmp(arg, "--engine") == 0 && strcmp(value, "threaded") == 0) {
+            sim_engine = ENGINE_THREADED;
+        } else if (strcmp(arg, "--policy") == 0 && strcmp(value, "rms") == 0) {
+            sched_policy = POLICY_RMS;
+        } else if (strcmp(arg, "--policy") == 0 && strcmp(value, "cp") == 0) {
+            sched_policy = POLICY_CRITICAL_PATH;
+        } else if (strcmp(arg, "--policy") == 0 && strcmp(value, "hybrid") == 0) {
+            sched_policy = POLICY_HYBRID;
+        } else if (strcmp(arg, "--policy") == 0 && strcmp(value, "edf") == 0) {
+            sched_policy = POLICY_EDF;
+        } else if (strcmp(arg, "--dispatch") == 0 && strcmp(value, "eft") == 0) {
+            dispatch_rule = DISPATCH_EFT;
+        } else if (strcmp(arg, "--dispatch") == 0 && strcmp(value, "first-idle") == 0) {
+            dispatch_rule = DISPATCH_FIRST_IDLE;
+        } else if (strcmp(arg, "--dispatch") == 0 && strcmp(value, "affinity") == 0) {
+            dispatch_rule = DISPATCH_AFFINITY;
+        } else if (strcmp(arg, "--cluster-size") == 0) {
+            cluster_size = atoi(value);
+        } else if (strcmp(arg, "--affinity-wait") == 0) {
+            affinity_wait = atoll(value);
+        } else if (strcmp(arg, "--speeds") == 0) {
+            if (!parse_core_speeds(value)) {
+                fprintf(stderr, "Core speeds must be a comma-separated list of 1-%d\n", MAX_SPEED);
+                return 1;
+            }
+        } else if (strcmp(arg, "--switch-cost") == 0) {
+            context_switch_cost = atoll(value);
+        } else if (strcmp(arg, "--migration-cost") == 0) {
+            migration_cost = atoll(value);
+        } else if (strcmp(arg, "--refill-cost") == 0) {
+            cache_refill_cost = atoll(value);
+        } else if (strcmp(arg, "--dag") == 0) {
+            dag_file = value;
+        } else if (strcmp(arg, "--generate") == 0) {
+            generate_tasks = atoi(value);
+        } else if (strcmp(arg, "--max-deps") == 0) {
+            max_deps = atoi(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            seed = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--convert") == 0) {
+            convert_path = value;
+        } else if (strcmp(arg, "--jobs-csv") == 0) {
+            snprintf(job_csv_path, sizeof(job_csv_path), "%s", value);
+        } else if (strcmp(arg, "--trace") == 0) {
+            snprintf(trace_path, sizeof(trace_path), "%s", value);
+        } else if (strcmp(arg, "--event-log") == 0) {
+            snprintf(event_log_path, sizeof(event_log_path), "%s", value);
+        } else if (strcmp(arg, "--decode-log") == 0) {
+            decode_path = value;
+        } else if (strcmp(arg, "--cp-weight") == 0) {
+            cp_weight = atoi(value);
+        } else if (strcmp(arg, "--unit") == 0 && strcmp(value, "ms") == 0) {
+            set_time_unit(TIME_UNIT_MS);
+        } else if (strcmp(arg, "--unit") == 0 && strcmp(value, "us") == 0) {
+            set_time_unit(TIME_UNIT_US);
+        } else if (strcmp(arg, "--unit") == 0 && strcmp(value, "ns") == 0) {
+            set_time_unit(TIME_UNIT_NS);
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "table") == 0) {
+            output_format = OUTPUT_TABLE;
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "summary") == 0) {
+            output_format = OUTPUT_SUMMARY;
+        } else if (strcmp(arg, "--format") == 0 && strcmp(value, "csv") == 0) {
+            output_format = OUTPUT_CSV;
+        } else {
+            fprintf(stderr, "Invalid option: %s %s\n", arg, value);
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;  // consumed the value
+    }
+    
+    if (num_cores < 1) {
+        fprintf(stderr, "Number of cores must be at least 1\n");
+        return 1;
+    }
+    if (quantum_arg > 0) {
+        if (quantum_arg < MIN_QUANTUM) {
+            fprintf(stderr, "Quantum must be at least %d time units\n", MIN_QUANTUM);
+            return 1;
+        }
+        quantum = quantum_arg;
+    }
+    if (horizon_arg > 0) {
+        simulation_horizon = horizon_arg;
+        horizon_is_default = false;
+    }
+    if (cp_weight < 0 || cp_weight > 100) {
+        fprintf(stderr, "Critical path weight must be between 0 and 100\n");
+        return 1;
+    }
+    if (context_switch_cost < 0 || migration_cost < 0 || cache_refill_cost < 0) {
+        fprintf(stderr, "Overhead costs must not be negative\n");
+        return 1;
+    }
+    if (cluster_size < 1 || affinity_wait < 0) {
+        fprintf(stderr, "Cluster size must be at least 1 and the affinity wait not negative\n");
+        return 1;
+    }
+    if (event_log_path[0] != '\0' && sim_engine != ENGINE_THREADED) {
+        fprintf(stderr, "--event-log needs --engine threaded\n");
+        return 1;
+    }
+    if (generate_tasks < 0 || max_deps < 1 || (generate_tasks > 0 && dag_file)) {
+        fprintf(stderr, "--generate needs a positive task count, --max-deps at least 1,\n"
+                        "and cannot be combined with --dag\n");
+        return 1;
+    }
+    
+    if (convert_path) {
+        if (!dag_file) {
+            fprintf(stderr, "--convert needs --dag FILE to convert\n");
+            return 1;
+        }
+        return convert_dag_file(dag_file, convert_path);
+    }
+    if (dag_file) {
+        current_dag = load_dag_file(dag_file);
+        if (!current_dag) {
+            return 1;
+        }
+    } else if (generate_tasks > 0) {
+        current_dag = create_random_dag(generate_tasks, max_deps, seed);
+    } else {
+        current_dag = create_sample_dag();
+    }
+    if (decode_path) {
+        int decoded = decode_event_log(current_dag, decode_path);
+        free_dag(current_dag);
+        current_dag = NULL;
+        return decoded;
+    }
+    
+    int status = 0;
+    bool skip = false;
+    if (analyze_only || precheck) {
+        SchedAnalysis analysis;
+        analyze_schedulability(current_dag, num_cores, &analysis);
+        if (output_format == OUTPUT_TABLE) {
+            print_schedulability_analysis(current_dag, num_cores, &analysis);
+        } else {
+            print_analysis_summary(&analysis);
+        }
+        skip = analyze_only || analysis.dag == VERDICT_FAIL;
+        if (!analyze_only && skip) status = 2;
+        free_schedulability_analysis(&analysis);
+    }
+    
+    if (!skip) {
+        simulate_hybrid_scheduler(current_dag, num_cores);
+        status = (completed_tasks == current_dag->num_tasks) ? 0 : 2;
+        if (compare) {
+            compare_policies(current_dag, num_cores);
+        }
+        if (check_engines && !compare_engines(current_dag, num_cores)) {
+            status = 3;
+        }
+    }
+    
+    free_dag(current_dag);
+    current_dag = NULL;
+    free(cores);
+    cores = NULL;
+    return status;
+}
+
+int main(int argc, char* argv[]) {
     int choice;
     int num_cores = 4;
+    int engine_choice;
+    int policy_choice;
+    int unit_choice;
+    int periodic_choice;
+    int rule_choice;
+    int edge_choice;
+    char dag_path[256];
+    char speed_list[256];
+    SimTime horizon;
     bool exit_program = false;
     
     // Seed random number generator
     srand(time(NULL));
     
+    if (argc > 1) {
+        return run_batch(argc, argv);
+    }
+    
     while (!exit_program) {
         printf("\nHybrid DAG-Based Multi-Core Scheduler with RMS - Main Menu\n");
         printf("=============================================\n");
         printf("1. Create Sample DAG\n");
-        printf("2. Create Custom DAG\n");
+        printf("2. Create Custom DAG (interactive or from a file)\n");
         printf("3. Display Current DAG\n");
         printf("4. Run Performance Comparison\n");
         printf("5. Export Results to CSV\n");
-        printf("6. Exit\n");
+        printf("6. Simulation Settings (time unit, horizon)\n");
+        printf("7. Exit\n");
         printf("Enter your choice: ");
         scanf("%d", &choice);
         
@@ -728,7 +4896,9 @@ int main() {
                 if (current_dag) {
                     free_dag(current_dag);
                 }
-                current_dag = create_custom_dag();
+                printf("Enter a DAG file (task/edge list or Graphviz DOT), or - to enter tasks here: ");
+                scanf("%255s", dag_path);
+                current_dag = (strcmp(dag_path, "-") == 0) ? create_custom_dag() : load_dag_file(dag_path);
                 break;
                 
             case 3:
@@ -736,31 +4906,54 @@ int main() {
                 break;
                 
             case 4:
-                printf("Enter number of cores (1-%d): ", MAX_CORES);
+                printf("Enter number of cores (at least 1): ");
                 scanf("%d", &num_cores);
                 
-                if (num_cores < 1 || num_cores > MAX_CORES) {
+                if (num_cores < 1) {
                     printf("Invalid number of cores. Using 4 cores.\n");
                     num_cores = 4;
                 }
                 
-                printf("Enter quantum for Round Robin (in ms): ");
-                scanf("%d", &quantum);
+                printf("Enter quantum for Round Robin (in %s): ", time_unit_label(time_unit));
+                scanf("%lld", &quantum);
                 
                 if (quantum < MIN_QUANTUM) {
-                    printf("Invalid quantum. Using default (%d ms).\n", DEFAULT_QUANTUM);
-                    quantum = DEFAULT_QUANTUM;
+                    quantum = DEFAULT_QUANTUM * ticks_per_ms(time_unit);
+                    printf("Invalid quantum. Using default (%lld %s).\n", quantum, time_unit_label(time_unit));
                 }
                 
                 // Enable debug mode for detailed execution trace
                 printf("Enable debug mode? (0-No, 1-Yes): ");
                 scanf("%d", (int*)&debug_mode);
                 
+                printf("Select simulation engine (0-Tick, 1-Event, 2-Threaded execution): ");
+                scanf("%d", &engine_choice);
+                sim_engine = (engine_choice == 0) ? ENGINE_TICK :
+                             (engine_choice == 2) ? ENGINE_THREADED : ENGINE_EVENT;
+                if (event_log_path[0] != '\0' && sim_engine != ENGINE_THREADED) {
+                    printf("Only the threaded engine writes the event log; %s is left as it is.\n",
+                           event_log_path);
+                }
+                
+                printf("Select dispatch policy (0-RMS, 1-Critical path, 2-Hybrid, 3-EDF): ");
+                scanf("%d", &policy_choice);
+                sched_policy = (policy_choice == 1) ? POLICY_CRITICAL_PATH :
+                               (policy_choice == 2) ? POLICY_HYBRID :
+                               (policy_choice == 3) ? POLICY_EDF : POLICY_RMS;
+                if (sched_policy == POLICY_HYBRID) {
+                    printf("Enter critical path weight in percent (0-100): ");
+                    scanf("%d", &cp_weight);
+                    if (cp_weight < 0 || cp_weight > 100) {
+                        cp_weight = DEFAULT_CP_WEIGHT;
+                        printf("Invalid weight. Using default (%d%%).\n", cp_weight);
+                    }
+                }
+                
                 run_performance_comparison(num_cores);
                 break;
                 
             case 5:
-                if (!current_dag) {
+                if (!current_dag || !cores) {
                     printf("No results available to export. Run a simulation first.\n");
                 } else {
                     export_results_to_csv(current_dag, "hybrid_rms", num_cores);
@@ -768,6 +4961,79 @@ int main() {
                 break;
                 
             case 6:
+                printf("Select time unit (0-ms, 1-us, 2-ns): ");
+                scanf("%d", &unit_choice);
+                set_time_unit(unit_choice == 2 ? TIME_UNIT_NS : unit_choice == 1 ? TIME_UNIT_US : TIME_UNIT_MS);
+                
+                printf("Enter simulation horizon in %s (0 for default of %d ms, or the hyperperiod\n"
+                       "for periodic releases): ", time_unit_label(time_unit), DEFAULT_HORIZON_MS);
+                scanf("%lld", &horizon);
+                simulation_horizon = (horizon > 0) ? horizon : DEFAULT_HORIZON_MS * ticks_per_ms(time_unit);
+                horizon_is_default = (horizon <= 0);
+                
+                printf("Release a job of every task each period? (0-No, 1-Yes): ");
+                scanf("%d", &periodic_choice);
+                periodic_mode = (periodic_choice == 1);
+                if (periodic_mode) {
+                    printf("Per-job CSV file (- for none): ");
+                    scanf("%255s", job_csv_path);
+                    if (strcmp(job_csv_path, "-") == 0) {
+                        job_csv_path[0] = '\0';
+                    }
+                }
+                
+                printf("Core speeds in percent of nominal, comma-separated (e.g. 200,100,50;\n"
+                       "- for all nominal): ");
+                scanf("%255s", speed_list);
+                if (!parse_core_speeds(speed_list)) {
+                    printf("Invalid speeds (1-%d each). Keeping previous speeds.\n", MAX_SPEED);
+                }
+                
+                printf("Dispatch rule (0-Earliest finish time, 1-First idle core, 2-Cache affinity): ");
+                scanf("%d", &rule_choice);
+                dispatch_rule = (rule_choice == 2) ? DISPATCH_AFFINITY :
+                                (rule_choice == 1) ? DISPATCH_FIRST_IDLE : DISPATCH_EFT;
+                if (dispatch_rule == DISPATCH_AFFINITY) {
+                    printf("Enter cores per cache cluster and the longest wait for it in %s: ",
+                           time_unit_label(time_unit));
+                    scanf("%d %lld", &cluster_size, &affinity_wait);
+                    if (cluster_size < 1 || affinity_wait < 0) {
+                        cluster_size = 1;
+                        affinity_wait = 0;
+                        printf("Invalid values. Using cluster size 1 and no wait.\n");
+                    }
+                }
+                
+                printf("Charge dependency transfer costs across cores? (0-No, 1-Yes): ");
+                scanf("%d", &edge_choice);
+                edge_costs_enabled = (edge_choice == 1);
+                
+                printf("Enter context-switch, migration and cache-refill costs in %s\n"
+                       "(e.g. 0 0 0): ", time_unit_label(time_unit));
+                scanf("%lld %lld %lld", &context_switch_cost, &migration_cost, &cache_refill_cost);
+                if (context_switch_cost < 0 || migration_cost < 0 || cache_refill_cost < 0) {
+                    context_switch_cost = migration_cost = cache_refill_cost = 0;
+                    printf("Invalid costs. Scheduling overhead disabled.\n");
+                }
+                
+                printf("Timeline trace file in Chrome Trace JSON (- for none): ");
+                scanf("%255s", trace_path);
+                if (strcmp(trace_path, "-") == 0) {
+                    trace_path[0] = '\0';
+                }
+                
+                printf("Binary event log of the threaded engine (- for none): ");
+                scanf("%255s", event_log_path);
+                if (strcmp(event_log_path, "-") == 0) {
+                    event_log_path[0] = '\0';
+                }
+                
+                printf("Time unit: %s, horizon: %lld %s, periodic releases: %s, dispatch: %s\n",
+                       time_unit_label(time_unit), simulation_horizon, time_unit_label(time_unit),
+                       periodic_mode ? "on" : "off", dispatch_rule_name(dispatch_rule));
+                break;
+                
+            case 7:
                 exit_program = true;
                 break;
                 
@@ -781,6 +5047,7 @@ int main() {
     if (current_dag) {
         free_dag(current_dag);
     }
+    free(cores);
     
     printf("Program terminated.\n");
     return 0;